@@ -0,0 +1,62 @@
+#include "Delegate.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+constexpr int batchSize = 256;
+constexpr int batches = 1'000;
+
+volatile int sink = 0;
+void handler(int x) { sink = x; }
+
+// Time delivering batches of events, and return the time per event.
+template<typename deliver_t>
+double nsPerEvent(deliver_t&& deliver)
+{
+    std::vector<std::tuple<int>> batch;
+    for (int i = 0; i < batchSize; ++i)
+    {
+        batch.emplace_back(i);
+    }
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < batches; ++i)
+    {
+        deliver(batch);
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / (batches * batchSize);
+}
+
+int main()
+{
+    std::cout << "Cost of delivering bursts of " << batchSize << " events (ns per event)\n";
+    std::cout << "handlers\toperator()\tEventMajor\tHandlerMajor\n";
+    for (int handlerCount : { 1, 4, 16, 64 })
+    {
+        Delegate<void, int> delegate;
+        for (int i = 0; i < handlerCount; ++i)
+        {
+            delegate += handler;
+        }
+        std::cout << handlerCount;
+        std::cout << '\t' << nsPerEvent([&delegate](std::vector<std::tuple<int>>& batch) {
+            for (auto& [x] : batch)
+            {
+                delegate(x);
+            }
+        });
+        for (auto order : { BatchOrder::EventMajor, BatchOrder::HandlerMajor })
+        {
+            std::cout << '\t' << nsPerEvent([&delegate, order](std::vector<std::tuple<int>>& batch) {
+                delegate.invokeBatch(batch, order);
+            });
+        }
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,53 @@
+#include "Delegate.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+constexpr int repetitions = 100'000;
+
+volatile int sink = 0;
+void handler(int x) { sink = x; }
+
+template<typename operation_t>
+double nsPerOperation(operation_t&& operation)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < repetitions; ++i)
+    {
+        operation();
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / repetitions;
+}
+
+int main()
+{
+    std::cout << "Cost of copying and moving a Delegate (ns per operation)\n";
+    std::cout << "handlers\tcopy\tmove\tcopy and modify\n";
+    for (int handlerCount : { 1, 64, 1024 })
+    {
+        Delegate<void, int> delegate;
+        for (int i = 0; i < handlerCount; ++i)
+        {
+            delegate += handler;
+        }
+        std::cout << handlerCount;
+        std::cout << '\t' << nsPerOperation([&delegate]() {
+            Delegate<void, int> copy(delegate);
+        });
+        std::cout << '\t' << nsPerOperation([&delegate]() {
+            Delegate<void, int> moved(std::move(delegate));
+            delegate = std::move(moved);
+        });
+        std::cout << '\t' << nsPerOperation([&delegate]() {
+            Delegate<void, int> copy(delegate);
+            copy -= handler;
+        });
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,62 @@
+#include "Delegate.h"
+#include "StopWatch.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+constexpr int invocations = 200'000;
+
+volatile int sink = 0;
+void handler(int x) { sink = x; }
+
+// Time invocations of the delegate while writerCount threads add and remove functions.
+double nsPerInvocation(Delegate<void, int>& delegate, int writerCount)
+{
+    std::atomic<bool> done = false;
+    std::vector<std::jthread> writers;
+    for (int writer = 0; writer < writerCount; ++writer)
+    {
+        writers.emplace_back([&delegate, &done]() {
+            auto lambda = [](int x) { sink = x + 1; };
+            while (!done)
+            {
+                delegate += lambda;
+                delegate -= lambda;
+            }
+        });
+    }
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < invocations; ++i)
+    {
+        delegate(i);
+    }
+    watch.stop();
+    done = true;
+    return static_cast<double>(watch.getDuration().count()) / invocations;
+}
+
+int main()
+{
+    std::cout << "Dispatch cost versus handler count (ns per invocation)\n";
+    std::cout << "handlers\t0 writers\t1 writer\t2 writers\n";
+    for (int handlerCount : { 1, 4, 16, 64, 256 })
+    {
+        Delegate<void, int> delegate;
+        for (int i = 0; i < handlerCount; ++i)
+        {
+            delegate += handler;
+        }
+        std::cout << handlerCount;
+        for (int writerCount : { 0, 1, 2 })
+        {
+            std::cout << '\t' << nsPerInvocation(delegate, writerCount);
+        }
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,59 @@
+#include "Event.h"
+#include "EventArgs.h"
+#include "Object.h"
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+using namespace jimo;
+
+constexpr std::size_t eventCount = 1'000'000;
+
+std::size_t allocatedBytes = 0;
+
+void* operator new(std::size_t size)
+{
+    allocatedBytes += size;
+    if (auto memory = std::malloc(size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+using event_t = Event<Object, EventArgs>;
+
+// Print the memory used by eventCount Events, of which subscribedCount have a handler.
+void report(std::size_t subscribedCount)
+{
+    allocatedBytes = 0;
+    auto events = std::make_unique<event_t[]>(eventCount);
+    for (std::size_t index = 0; index < subscribedCount; ++index)
+    {
+        events[index] += [](Object&, EventArgs&) {};
+    }
+    std::cout << subscribedCount << '\t' << allocatedBytes / (1024 * 1024) << " MiB\t" <<
+        static_cast<double>(allocatedBytes) / eventCount << " bytes\n";
+}
+
+int main()
+{
+    std::cout << "sizeof(Event): " << sizeof(event_t) << " bytes\n";
+    std::cout << "Heap memory used by " << eventCount << " Events\n";
+    std::cout << "subscribed\ttotal\tper Event\n";
+    report(0);
+    report(eventCount / 100);
+    report(eventCount);
+}
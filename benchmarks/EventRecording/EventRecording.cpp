@@ -0,0 +1,88 @@
+#include "EventRecorder.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::recording;
+using namespace jimo::timing;
+
+class PriceEventArgs : public EventArgs
+{
+    public:
+        PriceEventArgs(double price) : m_price(price) {}
+        double price() const noexcept { return m_price; }
+    private:
+        double m_price;
+};
+
+struct PriceSerializer
+{
+    std::size_t size(const PriceEventArgs&) const noexcept { return sizeof(double); }
+    void write(const PriceEventArgs& e, std::span<std::byte> out) const noexcept
+    {
+        auto price = e.price();
+        std::memcpy(out.data(), &price, sizeof(price));
+    }
+    PriceEventArgs read(std::span<const std::byte> in) const
+    {
+        double price;
+        std::memcpy(&price, in.data(), sizeof(price));
+        return PriceEventArgs(price);
+    }
+};
+
+class Ticker : public Object
+{
+    public:
+        Event<Ticker, PriceEventArgs> priceChanged;
+};
+
+constexpr int dispatches = 1'000'000;
+
+double nsPerDispatch(Ticker& ticker)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < dispatches; ++i)
+    {
+        PriceEventArgs e(i);
+        ticker.priceChanged(ticker, e);
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / dispatches;
+}
+
+int main()
+{
+    Ticker ticker;
+    double total = 0;
+    ticker.priceChanged += [&total](Ticker&, PriceEventArgs& e) { total += e.price(); };
+    // Room for every dispatch, so that none are dropped.
+    std::vector<std::uint64_t> memory((sizeof(EventLog::header) +
+        dispatches * EventLog::recordSize(sizeof(double))) / sizeof(std::uint64_t) + 1);
+    // Touch the memory first, so that page faults are not counted as recording time.
+    std::fill(memory.begin(), memory.end(), 0);
+    std::cout << "Cost of dispatching an Event with one handler (ns per dispatch)\n";
+    std::cout << "not recorded\trecorded\n";
+    auto notRecorded = nsPerDispatch(ticker);
+    EventRecorder<> recorder(std::as_writable_bytes(std::span(memory)));
+    recorder.record(ticker.priceChanged, 1, PriceSerializer());
+    auto recorded = nsPerDispatch(ticker);
+    std::cout << notRecorded << '\t' << recorded << '\n';
+
+    Ticker replayed;
+    replayed.priceChanged += [&total](Ticker&, PriceEventArgs& e) { total -= e.price(); };
+    EventReplayer<> replayer(std::as_bytes(std::span(memory)));
+    replayer.add(1, replayed.priceChanged, replayed, PriceSerializer());
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    auto count = replayer.replay(ReplaySpeed::Maximum);
+    watch.stop();
+    std::cout << "\nReplayed " << count << " dispatches at maximum speed in " <<
+        static_cast<double>(watch.getDuration().count()) / count << " ns per dispatch\n";
+}
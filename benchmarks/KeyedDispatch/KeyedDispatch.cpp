@@ -0,0 +1,76 @@
+#include "EventBus.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+class KeyedEventArgs : public EventArgs
+{
+    public:
+        KeyedEventArgs(int key) : m_key(key) {}
+        int key() const noexcept { return m_key; }
+    private:
+        int m_key;
+};
+
+class Publisher : public Object
+{
+    public:
+        Event<Publisher, KeyedEventArgs> published;
+};
+
+template<typename publish_t>
+double nsPerPublication(int count, publish_t&& publish)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < count; ++i)
+    {
+        publish(i);
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / count;
+}
+
+int main()
+{
+    std::cout << "Cost of publishing to one of N subscribers (ns per publication)\n";
+    std::cout << "subscribers\tfilter in handler\tEventBus\n";
+    for (int subscriberCount : { 1'000, 100'000 })
+    {
+        std::vector<int> received(subscriberCount);
+        Publisher publisher;
+        EventBus<int, Publisher, KeyedEventArgs> bus;
+        auto transaction = publisher.published.startTransaction();
+        for (int key = 0; key < subscriberCount; ++key)
+        {
+            // Each subscriber is interested in one key.
+            transaction += [key, &received](Publisher&, KeyedEventArgs& e) {
+                if (e.key() == key)
+                {
+                    ++received[key];
+                }
+            };
+            bus.subscribe(key, [key, &received](Publisher&, KeyedEventArgs&) { ++received[key]; });
+        }
+        transaction.commit();
+        // Spread the keys over all of the subscribers.
+        auto keyFor = [subscriberCount](int i) {
+            return static_cast<int>(i * 7919LL % subscriberCount);
+        };
+        std::cout << subscriberCount;
+        std::cout << '\t' << nsPerPublication(10'000'000 / subscriberCount,
+            [&publisher, &keyFor](int i) {
+                KeyedEventArgs e(keyFor(i));
+                publisher.published(publisher, e);
+            });
+        std::cout << '\t' << nsPerPublication(1'000'000, [&bus, &publisher, &keyFor](int i) {
+            KeyedEventArgs e(keyFor(i));
+            bus.publish(e.key(), publisher, e);
+        });
+        std::cout << '\n';
+    }
+}
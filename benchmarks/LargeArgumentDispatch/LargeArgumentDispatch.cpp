@@ -0,0 +1,64 @@
+#include "Delegate.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+constexpr int invocations = 200'000;
+
+// A 1 KiB argument, passed by value.
+struct Large
+{
+    int values[256];
+};
+
+volatile int sink = 0;
+void handler(const Large& large) { sink = large.values[0]; }
+
+template<typename call_t>
+double nsPerInvocation(call_t&& call)
+{
+    Large large {};
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < invocations; ++i)
+    {
+        large.values[0] = i;
+        call(large);
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / invocations;
+}
+
+int main()
+{
+    std::cout << "Dispatch cost of a 1 KiB argument passed by value (ns per invocation)\n";
+    std::cout << "handlers\tDelegate\tstd::function loop\n";
+    for (int handlerCount : { 1, 4, 16, 64 })
+    {
+        Delegate<void, Large> delegate;
+        // The functions are called the way Delegate called them before arguments were
+        // forwarded: each one receives its own copy of the argument.
+        std::vector<std::function<void(Large)>> functions;
+        for (int i = 0; i < handlerCount; ++i)
+        {
+            delegate += handler;
+            functions.emplace_back(handler);
+        }
+        std::cout << handlerCount;
+        std::cout << '\t' << nsPerInvocation([&delegate](const Large& large) {
+            delegate(large);
+        });
+        std::cout << '\t' << nsPerInvocation([&functions](Large large) {
+            for (const auto& function : functions)
+            {
+                function(large);
+            }
+        });
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,62 @@
+#include "Event.h"
+#include "StopWatch.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <iostream>
+
+using namespace jimo;
+using namespace jimo::timing;
+using namespace jimo::interthread;
+
+class Publisher : public Object
+{
+    public:
+        Event<Publisher, EventArgs> published;
+};
+
+// Busy wait, so that each handler uses the processor for the whole of its cost.
+void work(std::chrono::microseconds cost)
+{
+    auto end = std::chrono::steady_clock::now() + cost;
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+constexpr int publications = 200;
+
+template<typename publish_t>
+double usPerPublication(publish_t publish)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < publications; ++i)
+    {
+        publish();
+    }
+    watch.stop();
+    return std::chrono::duration<double, std::micro>(watch.getDuration()).count() / publications;
+}
+
+int main()
+{
+    ThreadPool pool;
+    std::cout << "Publish latency with handlers costing 5-40us (us per publication), " <<
+        pool.size() << " pool threads\n";
+    std::cout << "handlers\tsequential\tparallel\n";
+    for (int handlerCount : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        Publisher publisher;
+        for (int handler = 0; handler < handlerCount; ++handler)
+        {
+            std::chrono::microseconds cost(5 + 5 * (handler % 8));
+            publisher.published += [cost](Publisher&, EventArgs&) { work(cost); };
+        }
+        EventArgs e;
+        auto sequential = usPerPublication([&publisher, &e]() { publisher.published(publisher, e); });
+        auto parallel = usPerPublication([&publisher, &pool, &e]() {
+            publisher.published.invokeParallel(pool, publisher, e);
+        });
+        std::cout << handlerCount << '\t' << sequential << '\t' << parallel << '\n';
+    }
+}
@@ -0,0 +1,96 @@
+#include "DispatchQueue.h"
+#include "Event.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+using namespace jimo::interthread;
+
+class Publisher : public Object
+{
+    public:
+        Event<Publisher, EventArgs> published;
+};
+
+// Busy wait, so that the handler uses the processor for the whole of its cost.
+void work(std::chrono::microseconds cost)
+{
+    auto end = std::chrono::steady_clock::now() + cost;
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+// Fewer than the queue's capacity, so that the producer never waits for a free slot.
+constexpr int publications = 2000;
+constexpr int throughputPublications = 200000;
+
+template<typename publish_t>
+double nsPerPublication(publish_t publish)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < publications; ++i)
+    {
+        publish();
+    }
+    watch.stop();
+    return std::chrono::duration<double, std::nano>(watch.getDuration()).count() / publications;
+}
+
+double millionsPerSecond(int producers)
+{
+    Publisher publisher;
+    long long handled = 0;
+    publisher.published += [&handled](Publisher&, EventArgs&) { ++handled; };
+    StopWatch<std::chrono::steady_clock> watch;
+    {
+        DispatchQueue queue;
+        std::vector<std::jthread> threads;
+        watch.start();
+        for (int producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&publisher, &queue]() {
+                EventArgs e;
+                for (int i = 0; i < throughputPublications; ++i)
+                {
+                    publisher.published.post(queue, publisher, e);
+                }
+            });
+        }
+        threads.clear();
+        watch.stop();
+    }
+    auto seconds = std::chrono::duration<double>(watch.getDuration()).count();
+    return producers * throughputPublications / seconds / 1e6;
+}
+
+int main()
+{
+    std::cout << "Producer latency (ns per publication)\n";
+    std::cout << "handler cost (us)\tsynchronous\tpost\n";
+    for (int cost : { 0, 1, 10 })
+    {
+        Publisher publisher;
+        publisher.published += [cost](Publisher&, EventArgs&) {
+            work(std::chrono::microseconds(cost));
+        };
+        EventArgs e;
+        auto synchronous = nsPerPublication([&publisher, &e]() { publisher.published(publisher, e); });
+        DispatchQueue queue;
+        auto posted = nsPerPublication([&publisher, &queue, &e]() {
+            publisher.published.post(queue, publisher, e);
+        });
+        std::cout << cost << '\t' << synchronous << '\t' << posted << '\n';
+    }
+    std::cout << "\nProducer throughput with an empty handler (millions of publications per second)\n";
+    std::cout << "producers\tpost\n";
+    for (int producers : { 1, 2, 4 })
+    {
+        std::cout << producers << '\t' << millionsPerSecond(producers) << '\n';
+    }
+}
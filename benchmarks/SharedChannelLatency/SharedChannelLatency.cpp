@@ -0,0 +1,154 @@
+#include "SharedEventChannel.h"
+#include "StopWatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace jimo;
+using namespace jimo::interprocess;
+using namespace jimo::timing;
+
+class StampEventArgs : public EventArgs
+{
+    public:
+        StampEventArgs(std::int64_t stamp = 0) : m_stamp(stamp) {}
+        std::int64_t stamp() const noexcept { return m_stamp; }
+    private:
+        std::int64_t m_stamp;
+};
+
+struct StampSerializer
+{
+    std::size_t size(const StampEventArgs&) const noexcept { return sizeof(std::int64_t); }
+    void write(const StampEventArgs& e, std::span<std::byte> out) const noexcept
+    {
+        auto stamp = e.stamp();
+        std::memcpy(out.data(), &stamp, sizeof(stamp));
+    }
+    StampEventArgs read(std::span<const std::byte> in) const
+    {
+        std::int64_t stamp;
+        std::memcpy(&stamp, in.data(), sizeof(stamp));
+        return StampEventArgs(stamp);
+    }
+};
+
+using StampChannel = SharedEventChannel<StampEventArgs, StampSerializer>;
+
+struct phase
+{
+    const char* name;
+    int events;
+    std::chrono::microseconds interval;
+};
+
+// Short intervals keep the receiver spinning; long ones let it sleep on the futex.
+constexpr phase phases[] = {
+    { "receiver spinning (every 20 us)", 20'000, std::chrono::microseconds(20) },
+    { "receiver sleeping (every 2 ms)", 1'000, std::chrono::microseconds(2'000) },
+};
+constexpr int burst = 1'000'000;
+
+std::int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs in the child process. steady_clock is the system-wide monotonic clock, so the
+// stamps published by the parent can be compared with it.
+int receive(const std::string& name, int ready)
+{
+    StampChannel channel(name);
+    std::vector<std::int64_t> latencies;
+    std::int64_t received = 0;
+    channel.received += [&latencies, &received](StampChannel&, StampEventArgs& e) {
+        latencies.push_back(now() - e.stamp());
+        ++received;
+    };
+    char byte = 0;
+    if (::write(ready, &byte, 1) != 1)
+    {
+        return 1;
+    }
+    std::cout << "Publish to handler latency in another process (ns)\n";
+    std::cout << "case\t\t\t\tmedian\t99th percentile\n";
+    for (auto& current : phases)
+    {
+        latencies.clear();
+        latencies.reserve(current.events);
+        while (latencies.size() < static_cast<std::size_t>(current.events))
+        {
+            channel.wait(std::chrono::seconds(5));
+            // Leave the next phase's events in the channel.
+            channel.poll(current.events - latencies.size());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << current.name << '\t' << latencies[latencies.size() / 2] << '\t' <<
+            latencies[latencies.size() * 99 / 100] << '\n';
+    }
+    received = 0;
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    while (received + static_cast<std::int64_t>(channel.dropped()) < burst)
+    {
+        channel.wait(std::chrono::seconds(5));
+        channel.poll();
+    }
+    watch.stop();
+    std::cout << "\nBurst of " << burst << " events: received " << received << ", dropped " <<
+        channel.dropped() << ", " << static_cast<double>(watch.getDuration().count()) / burst <<
+        " ns per event" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    auto name = "/jimoSharedChannelLatency" + std::to_string(::getpid());
+    StampChannel channel(name, 65'536, sizeof(std::int64_t));
+    int pipes[2];
+    if (::pipe(pipes) != 0)
+    {
+        return 1;
+    }
+    auto child = ::fork();
+    if (child == 0)
+    {
+        ::_exit(receive(name, pipes[1]));
+    }
+    char byte;
+    if (::read(pipes[0], &byte, 1) != 1)
+    {
+        return 1;
+    }
+    for (auto& current : phases)
+    {
+        for (int event = 0; event < current.events; ++event)
+        {
+            auto next = std::chrono::steady_clock::now() + current.interval;
+            channel.publish(StampEventArgs(now()));
+            while (std::chrono::steady_clock::now() < next)
+            {
+            }
+        }
+    }
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int event = 0; event < burst; ++event)
+    {
+        channel.publish(StampEventArgs(event));
+    }
+    watch.stop();
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    std::cout << "Publishing the burst took " <<
+        static_cast<double>(watch.getDuration().count()) / burst << " ns per event\n";
+    return status;
+}
@@ -0,0 +1,69 @@
+#include "Delegate.h"
+#include "StopWatch.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace jimo;
+using namespace jimo::timing;
+
+constexpr int lookups = 10'000;
+
+class Subscriber
+{
+    public:
+        void handle(int x) { m_value = x; }
+    private:
+        int m_value = 0;
+};
+
+using binding_t = MethodBinding<void, Subscriber, decltype(&Subscriber::handle)>;
+
+template<typename operation_t>
+double nsPerOperation(int count, operation_t&& operation)
+{
+    StopWatch<std::chrono::steady_clock> watch;
+    watch.start();
+    for (int i = 0; i < count; ++i)
+    {
+        operation(i);
+    }
+    watch.stop();
+    return static_cast<double>(watch.getDuration().count()) / count;
+}
+
+int main()
+{
+    std::cout << "Cost of finding and removing subscribers (ns per operation)\n";
+    std::cout << "subscribers\tcontains\tcontains (absent)\t-= (absent)\n";
+    for (int subscriberCount : { 100, 1'000, 10'000 })
+    {
+        std::vector<Subscriber> subscribers(subscriberCount);
+        Subscriber absent;
+        Delegate<void, int> delegate;
+        auto transaction = delegate.startTransaction();
+        for (auto& subscriber : subscribers)
+        {
+            transaction += binding_t { &subscriber, &Subscriber::handle };
+        }
+        transaction.commit();
+        std::cout << subscriberCount;
+        std::cout << '\t' << nsPerOperation(lookups, [&delegate, &subscribers](int i) {
+            if (!delegate.contains(binding_t { &subscribers[i % subscribers.size()],
+                &Subscriber::handle }))
+            {
+                std::cout << "missing subscriber\n";
+            }
+        });
+        std::cout << '\t' << nsPerOperation(lookups, [&delegate, &absent](int) {
+            if (delegate.contains(binding_t { &absent, &Subscriber::handle }))
+            {
+                std::cout << "unexpected subscriber\n";
+            }
+        });
+        std::cout << '\t' << nsPerOperation(lookups, [&delegate, &absent](int) {
+            delegate -= binding_t { &absent, &Subscriber::handle };
+        });
+        std::cout << '\n';
+    }
+}
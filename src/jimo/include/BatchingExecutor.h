@@ -0,0 +1,98 @@
+/// @file BatchingExecutor.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Executor.h"
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace jimo::interthread
+{
+    /// @brief An Executor that collects tasks and passes them to another Executor in batches.
+    ///
+    /// The first task posted to an idle BatchingExecutor posts a single drain task to the
+    /// target Executor. Tasks posted before the drain task finishes are added to its
+    /// batches, without posting anything to the target, and the drain task runs them all, in
+    /// the order they were posted. Posting many tasks in a burst therefore wakes the target's
+    /// thread once, rather than once for each task.
+    ///
+    /// Tasks in a batch run one after another on the target's thread, so a BatchingExecutor
+    /// over a ThreadPool runs its tasks one at a time, like a strand. The target must outlive
+    /// the BatchingExecutor. Tasks must not throw exceptions.
+    class BatchingExecutor : public Executor
+    {
+        public:
+            /// @brief Constructor
+            /// @param target The Executor to post batches to.
+            explicit BatchingExecutor(Executor& target) : m_target(target) {}
+            /// @brief Copy constructor
+            BatchingExecutor(const BatchingExecutor&) = delete;
+            /// @brief Move constructor
+            BatchingExecutor(BatchingExecutor&&) = delete;
+            /// @brief Destructor
+            ///
+            /// Waits until the target has run all of the tasks that have been posted. It must
+            /// not be called by one of those tasks.
+            virtual ~BatchingExecutor() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_idle.wait(lock, [this]() { return !m_scheduled; });
+            }
+            /// @brief Copy equals operator
+            BatchingExecutor& operator =(const BatchingExecutor&) = delete;
+            /// @brief Move equals operator
+            BatchingExecutor& operator =(BatchingExecutor&&) = delete;
+            /// @brief Add a task to the current batch, posting the batch to the target if
+            /// it is the first task.
+            /// @param task The task to run.
+            void post(task_t task) override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_pending.push_back(std::move(task));
+                    if (m_scheduled)
+                    {
+                        return;
+                    }
+                    m_scheduled = true;
+                }
+                m_target.post([this]() { drain(); });
+            }
+        private:
+            void drain()
+            {
+                std::vector<task_t> batch;
+                std::unique_lock<std::mutex> lock(m_lock);
+                // Tasks posted while a batch runs form the next batch. m_scheduled stays set
+                // until there are none, so that batches never run concurrently.
+                while (!m_pending.empty())
+                {
+                    // Swapping reuses the capacity of both vectors, so steady-state batches
+                    // do not allocate.
+                    batch.swap(m_pending);
+                    lock.unlock();
+                    for (auto& task : batch)
+                    {
+                        task();
+                    }
+                    batch.clear();
+                    lock.lock();
+                }
+                if (m_pending.capacity() < batch.capacity())
+                {
+                    m_pending.swap(batch);
+                }
+                m_scheduled = false;
+                m_idle.notify_all();
+            }
+
+            Executor& m_target;
+            std::mutex m_lock;
+            std::condition_variable m_idle;
+            std::vector<task_t> m_pending;
+            bool m_scheduled = false;
+    };
+}
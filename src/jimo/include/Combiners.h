@@ -0,0 +1,174 @@
+/// @file Combiners.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <concepts>
+#include <optional>
+#include <utility>
+
+/// @brief Result combiners for Delegate::invokeWith.
+namespace jimo::combiners
+{
+    /// @brief The requirements for a combiner that folds the results of a Delegate's functions.
+    ///
+    /// Delegate::invokeWith passes the result of each function to the combiner's
+    /// function call operator as soon as the function returns. The operator returns true to
+    /// continue invoking functions, or false to skip the remaining functions.
+    /// Delegate::invokeWith then returns the value of the combiner's result method.
+    /// @tparam combiner_t The combiner type.
+    /// @tparam value_t The result type of the Delegate's functions.
+    template<typename combiner_t, typename value_t>
+    concept Combiner = requires(combiner_t combiner, value_t value)
+    {
+        { combiner(std::move(value)) } -> std::convertible_to<bool>;
+        combiner.result();
+    };
+
+    /// @brief Adds the results of all of the functions.
+    /// @tparam value_t The result type of the functions.
+    template<typename value_t>
+    class Sum
+    {
+        public:
+            /// @brief Construct a Sum.
+            /// @param initial The value to add the results to.
+            Sum(value_t initial = value_t()) : m_sum(std::move(initial)) {}
+            /// @brief Add a result.
+            /// @param value The result to add.
+            /// @return true, because all functions are invoked.
+            bool operator ()(value_t value)
+            {
+                m_sum += value;
+                return true;
+            }
+            /// @brief Retrieve the sum.
+            /// @return The sum of the initial value and the results.
+            const value_t& result() const noexcept { return m_sum; }
+        private:
+            value_t m_sum;
+    };
+
+    /// @brief Retrieves the largest result of all of the functions.
+    /// @tparam value_t The result type of the functions.
+    template<typename value_t>
+    requires std::totally_ordered<value_t>
+    class Maximum
+    {
+        public:
+            /// @brief Compare a result with the largest result so far.
+            /// @param value The result.
+            /// @return true, because all functions are invoked.
+            bool operator ()(value_t value)
+            {
+                if (!m_maximum || *m_maximum < value)
+                {
+                    m_maximum = std::move(value);
+                }
+                return true;
+            }
+            /// @brief Retrieve the largest result.
+            /// @return The largest result, or an empty optional if no function was invoked.
+            const std::optional<value_t>& result() const noexcept { return m_maximum; }
+        private:
+            std::optional<value_t> m_maximum;
+    };
+
+    /// @brief Retrieves the smallest result of all of the functions.
+    /// @tparam value_t The result type of the functions.
+    template<typename value_t>
+    requires std::totally_ordered<value_t>
+    class Minimum
+    {
+        public:
+            /// @brief Compare a result with the smallest result so far.
+            /// @param value The result.
+            /// @return true, because all functions are invoked.
+            bool operator ()(value_t value)
+            {
+                if (!m_minimum || value < *m_minimum)
+                {
+                    m_minimum = std::move(value);
+                }
+                return true;
+            }
+            /// @brief Retrieve the smallest result.
+            /// @return The smallest result, or an empty optional if no function was invoked.
+            const std::optional<value_t>& result() const noexcept { return m_minimum; }
+        private:
+            std::optional<value_t> m_minimum;
+    };
+
+    /// @brief Checks that all of the functions return true.
+    ///
+    /// No more functions are invoked after one returns false.
+    class AllTrue
+    {
+        public:
+            /// @brief Check a result.
+            /// @param value The result.
+            /// @return true to continue invoking functions if value is true, false otherwise.
+            bool operator ()(bool value) noexcept
+            {
+                m_result = value;
+                return value;
+            }
+            /// @brief Retrieve the combined result.
+            /// @return true if every invoked function returned true, or if there were no
+            /// functions, false otherwise.
+            bool result() const noexcept { return m_result; }
+        private:
+            bool m_result { true };
+    };
+
+    /// @brief Checks if any of the functions return true.
+    ///
+    /// No more functions are invoked after one returns true.
+    class AnyTrue
+    {
+        public:
+            /// @brief Check a result.
+            /// @param value The result.
+            /// @return false to stop invoking functions if value is true, true otherwise.
+            bool operator ()(bool value) noexcept
+            {
+                m_result = value;
+                return !value;
+            }
+            /// @brief Retrieve the combined result.
+            /// @return true if a function returned true, false otherwise.
+            bool result() const noexcept { return m_result; }
+        private:
+            bool m_result { false };
+    };
+
+    /// @brief Retrieves the first result that is not empty.
+    ///
+    /// A result is empty if it converts to false; for example, an empty std::optional or
+    /// a nullptr. No more functions are invoked after one returns a non-empty result.
+    /// @tparam value_t The result type of the functions.
+    template<typename value_t>
+    requires std::constructible_from<bool, const value_t&>
+    class FirstNonEmpty
+    {
+        public:
+            /// @brief Check a result.
+            /// @param value The result.
+            /// @return false to stop invoking functions if value is not empty, true otherwise.
+            bool operator ()(value_t value)
+            {
+                if (static_cast<bool>(value))
+                {
+                    m_result = std::move(value);
+                    return false;
+                }
+                return true;
+            }
+            /// @brief Retrieve the first non-empty result.
+            /// @return The first non-empty result, or a value initialized value_t if every
+            /// result was empty.
+            const value_t& result() const noexcept { return m_result; }
+        private:
+            value_t m_result {};
+    };
+}
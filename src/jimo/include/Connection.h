@@ -0,0 +1,183 @@
+/// @file Connection.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace jimo
+{
+    /// @brief A table of connection slots shared by a Delegate and its Connections.
+    ///
+    /// Each slot holds a generation count. A function added with Delegate::subscribe
+    /// records its slot's generation, and is live only while the slot still holds that
+    /// generation. Disconnecting increments the generation, which removes the function from
+    /// the Delegate in constant time, and returns the slot for reuse.
+    ///
+    /// This class is used by Delegate and Connection; you do not use it directly.
+    class ConnectionSlots
+    {
+        public:
+            /// @brief A slot acquired for a new connection.
+            struct slot
+            {
+                /// @brief The index of the slot in the table.
+                std::uint32_t index;
+                /// @brief The generation of the slot when it was acquired.
+                std::uint32_t generation;
+                /// @brief The slot's generation count. This address is stable for the
+                /// lifetime of the table.
+                const std::atomic<std::uint32_t>* current;
+            };
+            /// @brief Acquire an unused slot.
+            /// @return The acquired slot.
+            slot acquire()
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                std::uint32_t index;
+                if (m_free.empty())
+                {
+                    index = static_cast<std::uint32_t>(m_generations.size());
+                    m_generations.emplace_back(0);
+                    // Reserving here guarantees that release never allocates.
+                    m_free.reserve(m_generations.size());
+                }
+                else
+                {
+                    index = m_free.back();
+                    m_free.pop_back();
+                }
+                auto& current = m_generations[index];
+                return { index, current.load(std::memory_order_relaxed), &current };
+            }
+            /// @brief Release a slot, disconnecting the function that holds it.
+            /// @param index The index of the slot.
+            /// @param generation The generation of the slot when it was acquired.
+            /// @return true if the slot was released, false if it was already released.
+            bool release(std::uint32_t index, std::uint32_t generation) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto& current = m_generations[index];
+                if (current.load(std::memory_order_relaxed) != generation)
+                {
+                    return false;
+                }
+                current.store(generation + 1, std::memory_order_release);
+                m_free.push_back(index);
+                return true;
+            }
+            /// @brief Check if a slot has not been released.
+            /// @param index The index of the slot.
+            /// @param generation The generation of the slot when it was acquired.
+            /// @return true if the slot still holds generation, false otherwise.
+            bool connected(std::uint32_t index, std::uint32_t generation) const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_generations[index].load(std::memory_order_relaxed) == generation;
+            }
+        private:
+            mutable std::mutex m_lock;
+            // A deque never moves its elements when it grows, so the generation counts
+            // can be read without holding m_lock.
+            std::deque<std::atomic<std::uint32_t>> m_generations;
+            std::vector<std::uint32_t> m_free;
+    };
+
+    /// @brief A handle to a function that was added to a Delegate or Event with subscribe.
+    ///
+    /// Calling disconnect removes the function from the Delegate in constant time. The
+    /// function is skipped by all later invocations, and is removed from the Delegate's
+    /// invocation list the next time the Delegate is modified or invoked.
+    ///
+    /// A Connection does not keep the Delegate alive. Disconnecting after the Delegate has
+    /// been destroyed or cleared does nothing. A Connection controls only the Delegate that
+    /// returned it, not copies of that Delegate.
+    class Connection
+    {
+        public:
+            /// @brief Construct a Connection that is not connected to any function.
+            Connection() = default;
+            /// @brief Construct a Connection for a slot.
+            ///
+            /// This constructor is called by Delegate::subscribe.
+            /// @param slots The slot table containing the slot.
+            /// @param slot The slot that controls the function.
+            Connection(const std::shared_ptr<ConnectionSlots>& slots,
+                const ConnectionSlots::slot& slot) noexcept
+                : m_slots(slots), m_index(slot.index), m_generation(slot.generation) {}
+            /// @brief Remove the function from the Delegate.
+            void disconnect() noexcept
+            {
+                if (auto slots = m_slots.lock())
+                {
+                    slots->release(m_index, m_generation);
+                }
+                m_slots.reset();
+            }
+            /// @brief Check if the function is still in the Delegate.
+            /// @return true if the function has not been disconnected or removed,
+            /// false otherwise.
+            bool connected() const noexcept
+            {
+                auto slots = m_slots.lock();
+                return slots && slots->connected(m_index, m_generation);
+            }
+        private:
+            std::weak_ptr<ConnectionSlots> m_slots;
+            std::uint32_t m_index { 0 };
+            std::uint32_t m_generation { 0 };
+    };
+
+    /// @brief A Connection that disconnects its function when it is destroyed.
+    class ScopedConnection
+    {
+        public:
+            /// @brief Construct a ScopedConnection that is not connected to any function.
+            ScopedConnection() = default;
+            /// @brief Construct a ScopedConnection that takes ownership of a Connection.
+            /// @param connection The connection to disconnect on destruction.
+            ScopedConnection(Connection connection) noexcept
+                : m_connection(std::move(connection)) {}
+            /// @brief Copy constructor
+            ScopedConnection(const ScopedConnection&) = delete;
+            /// @brief Move constructor
+            /// @param other The ScopedConnection to move. It is not connected after the move.
+            ScopedConnection(ScopedConnection&& other) noexcept
+                : m_connection(std::exchange(other.m_connection, Connection())) {}
+            /// @brief Destructor. Disconnects the function.
+            ~ScopedConnection() { m_connection.disconnect(); }
+            /// @brief Copy equals operator
+            ScopedConnection& operator =(const ScopedConnection&) = delete;
+            /// @brief Move equals operator
+            ///
+            /// Disconnects the current function before taking ownership of other's connection.
+            /// @param other The ScopedConnection to move. It is not connected after the move.
+            /// @return This ScopedConnection.
+            ScopedConnection& operator =(ScopedConnection&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    m_connection.disconnect();
+                    m_connection = std::exchange(other.m_connection, Connection());
+                }
+                return *this;
+            }
+            /// @brief Remove the function from the Delegate.
+            void disconnect() noexcept { m_connection.disconnect(); }
+            /// @brief Check if the function is still in the Delegate.
+            /// @return true if the function has not been disconnected or removed,
+            /// false otherwise.
+            bool connected() const noexcept { return m_connection.connected(); }
+            /// @brief Release ownership of the connection without disconnecting it.
+            /// @return The connection.
+            Connection release() noexcept { return std::exchange(m_connection, Connection()); }
+        private:
+            Connection m_connection;
+    };
+}
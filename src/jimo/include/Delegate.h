@@ -5,15 +5,43 @@
 
 #include <functional>
 #include <memory>
+#include <atomic>
 #include <vector>
 #include <algorithm>
 #include <iterator>
 #include <mutex>
 #include <initializer_list>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <bit>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+#include "Combiners.h"
+#include "Connection.h"
 #include "EventArgs.h"
+#include "InplaceFunction.h"
+#include "Instrumentation.h"
+#include "MethodBinding.h"
+#include "ThreadPool.h"
 
 namespace jimo
 {
+    /// @brief The order in which Delegate::invokeBatch and Event::invokeBatch call the
+    /// functions.
+    enum class BatchOrder
+    {
+        /// @brief Call every function with the first arguments, then every function with
+        /// the next arguments, and so on. This is the order of repeated invocations.
+        EventMajor,
+        /// @brief Call the first function with every set of arguments, then the next
+        /// function with every set of arguments, and so on. Each function's code and data
+        /// stay in the cache while it processes the whole batch.
+        HandlerMajor,
+    };
+
     /// @sa Event which is a specific type of Delegate.
     /// @sa Here are some example programs:
     /// [Delegate1](https://github.com/jimorc/jimo/tree/main/examples/Delegate/Delegate1),
@@ -24,7 +52,10 @@ namespace jimo
     /// class instances and instance methods, Functors, or lambdas 
     /// that can be used as callbacks or event handlers.
     ///
-    /// This class is thread safe.
+    /// This class is thread safe. The functions are held in an immutable snapshot that
+    /// +=, -=, and clear replace atomically, so invoking a Delegate neither locks nor copies
+    /// the function list. Functions added or removed while an invocation is in progress take
+    /// effect with the next invocation.
     ///
     /// Here is the code from the Delegate1 program.
     /// This illustrates the use of the Delegate class:
@@ -36,28 +67,145 @@ namespace jimo
     {
         public:
             /// @brief function_t pointer type
-            using function_t = std::function<result_t(arguments_t...)>;
+            ///
+            /// Functions are stored in place, so adding a function to a Delegate never
+            /// allocates memory for the function itself. See InplaceFunction for the
+            /// size limit on stored callables.
+            using function_t = InplaceFunction<result_t(arguments_t...)>;
+            /// @brief A function and the priority to add it with.
+            ///
+            /// This allows a function to be added with
+            /// <code>delegate += { function, priority };</code>
+            struct prioritized
+            {
+                /// @brief The function to add.
+                function_t function;
+                /// @brief The priority of the function. Functions with higher priorities are
+                /// invoked before functions with lower priorities. Functions with the same
+                /// priority are invoked in the order they were added. Functions added without
+                /// a priority have priority 0.
+                int priority = 0;
+            };
+            /// @brief A set of changes to a Delegate that are applied together.
+            ///
+            /// Additions and removals are staged in the transaction, and are applied, in the
+            /// order they were staged, by commit. Committing locks the Delegate once and
+            /// publishes a single new function list, so invocations running on other threads
+            /// see either all of the changes or none of them. Changes that have not been
+            /// committed when the transaction is destroyed are discarded.
+            ///
+            /// A transaction is not thread safe; stage changes on one thread only.
+            class transaction
+            {
+                public:
+                    /// @brief Construct a transaction for a Delegate.
+                    /// @param delegate The Delegate to change. It must outlive the transaction.
+                    explicit transaction(Delegate& delegate) noexcept : m_delegate(delegate) {}
+                    /// @brief Stage the addition of a function.
+                    /// @param function The function to add.
+                    /// @return This transaction.
+                    transaction& operator +=(const function_t& function)
+                    {
+                        m_changes.push_back({ function, 0, true });
+                        return *this;
+                    }
+                    /// @brief Stage the addition of a function with a priority.
+                    /// @param function The function and its priority.
+                    /// @return This transaction.
+                    transaction& operator +=(const prioritized& function)
+                    {
+                        m_changes.push_back({ function.function, function.priority, true });
+                        return *this;
+                    }
+                    /// @brief Stage the removal of a function.
+                    /// @param function The function to remove.
+                    /// @return This transaction.
+                    transaction& operator -=(const function_t& function)
+                    {
+                        m_changes.push_back({ function, 0, false });
+                        return *this;
+                    }
+                    /// @brief Stage the removal of all functions, including those added before
+                    /// the transaction was started. Changes staged before this call are discarded.
+                    void clear() noexcept
+                    {
+                        m_changes.clear();
+                        m_clear = true;
+                    }
+                    /// @brief Retrieve the number of staged changes.
+                    /// @return The number of staged additions and removals.
+                    size_t size() const noexcept { return m_changes.size(); }
+                    /// @brief Apply the staged changes to the Delegate.
+                    ///
+                    /// The transaction is empty afterwards, and may be reused. If an exception is
+                    /// thrown, the Delegate's function list is not replaced, and the changes
+                    /// remain staged.
+                    void commit()
+                    {
+                        std::lock_guard<std::mutex> lock(m_delegate.functionsLock());
+                        m_delegate.modify([this](invocation_list& list) {
+                            if (m_clear)
+                            {
+                                for (const auto& invocation : list.invocations)
+                                {
+                                    release(list, invocation);
+                                }
+                                list.invocations.clear();
+                            }
+                            for (const auto& change : m_changes)
+                            {
+                                if (change.add)
+                                {
+                                    insert(list, { change.function, nullptr, 0, 0, {}, false,
+                                        change.priority });
+                                }
+                                else
+                                {
+                                    remove(list, change.function);
+                                }
+                            }
+                        });
+                        m_changes.clear();
+                        m_clear = false;
+                    }
+                private:
+                    struct change
+                    {
+                        function_t function;
+                        int priority;
+                        bool add;
+                    };
+                    Delegate& m_delegate;
+                    std::vector<change> m_changes;
+                    bool m_clear = false;
+            };
             /// @brief Initializes an empty Delegate
             Delegate() = default;
             /// @brief Copy constructor
+            ///
+            /// The copy shares other's immutable function list, so copying takes constant time
+            /// regardless of the number of functions. The list is copied only when either
+            /// Delegate is modified. If other contains functions added with subscribe, the
+            /// list is copied immediately, because those functions must not be controlled by
+            /// other's Connections in the copy.
             /// @param other The Delegate object to copy.
-            Delegate(const Delegate& other) noexcept
+            Delegate(const Delegate& other)
             {
-                m_data->functions = other.m_data->functions;
+                publish(detached(other.functions()));
             }
             /// @brief Move constructor
+            ///
+            /// Takes ownership of other's storage in constant time, without allocating memory.
+            /// other is empty after the move.
             /// @param other The Delegate object to move.
             Delegate(Delegate&& other) noexcept
-            {
-                m_data->functions = other.m_data->functions;
-                other.m_data->functions.clear();
-            }
+                : m_data(other.m_data.exchange(nullptr, std::memory_order_acq_rel)) {}
             /// @brief Constructs a Delegate object from a function, static class method, or a Functor.
             /// @param function The function, static class method, or Functor to place as the first function
             /// in the new Delegate object.
             Delegate(const function_t& function)
             {
-                m_data->functions.push_back(function);
+                combine(function);
             }
             /// @brief Construct Delegate object from intitializer_list of Delegate objects.
             /// @param delegates List of delegates to construct Delegate object from.
@@ -88,216 +236,259 @@ namespace jimo
             Delegate(const std::initializer_list<const function_t>& functions,
                 const std::initializer_list<Delegate<result_t, arguments_t...>>&
                     delegates)
-                : Delegate(functions), Delegate(delegates) {}
-            /// @brief Constructor that takes const method with no parameters
-            /// @tparam object_t The type of the class containing the method to store as the delegate.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)() const) noexcept
+                : Delegate(functions)
             {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object)));
-            }
-            /// @brief Constructor that takes a const method with one parameter
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t) const) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1));
-            }
-            /// @brief Constructor that takes a const method with two parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's first parameter type.
-            /// @tparam arg2_t The method's second parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t) const) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2));
-            }
-            /// @brief Constructor that takes a const method with three parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's first parameter type.
-            /// @tparam arg2_t The method's second parameter type.
-            /// @tparam arg3_t The method's third parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t) const) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-            }
-            /// @brief Constructor that takes a const method with four parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's first parameter type.
-            /// @tparam arg2_t The method's second parameter type.
-            /// @tparam arg3_t The method's third parameter type.
-            /// @tparam arg4_t The method's fourth parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t,
-                typename arg4_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t,
-                arg4_t) const) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
-                    std::placeholders::_4));
-            }
-            /// @brief Constructor that takes a const method with five parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's first parameter type.
-            /// @tparam arg2_t The method's second parameter type.
-            /// @tparam arg3_t The method's third parameter type.
-            /// @tparam arg4_t The method's fourth parameter type.
-            /// @tparam arg5_t The method's fifth parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t,
-                typename arg4_t, typename arg5_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t,
-                arg4_t, arg5_t) const) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
-                    std::placeholders::_4, std::placeholders::_5));
+                for (const auto& delegate : delegates)
+                {
+                    *this += delegate;
+                }
             }
-            /// @brief Constructor that takes a non-const method with no parameters
+            /// @brief Constructor that takes a const method with any number of parameters
+            ///
+            /// The object and method are stored as a pair, so Delegates created from the same
+            /// object and method compare equal, and can be removed with -=.
             /// @tparam object_t The type of the class containing the method to store as the delegate.
+            /// @tparam method_arguments_t The method's parameter types.
             /// @param object The class instance for the method.
             /// @param method The method to call.
-            template<typename object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)()) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object)));
-            }
-            /// @brief Constructor that takes a non-const method with one parameter
-            /// @tparam object_t The type of the class containing the method to store as a delegate
-            /// @tparam arg_t The method's parameter type
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t)) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1));
-            }
-            /// @brief Constructor that takes a non-const method with two parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The method's first parameter type.
-            /// @tparam arg2_t The method's second parameter type.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t>
+            template<typename object_t, typename... method_arguments_t>
             requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t)) noexcept
+            Delegate(const object_t& object,
+                result_t(object_t::*method)(method_arguments_t...) const) noexcept
             {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2));
+                combine(MethodBinding<result_t, const object_t, decltype(method)>{ &object, method });
             }
-            /// @brief Constructor that takes a non-const method with three parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The type of the method's first parameter.
-            /// @tparam arg2_t The type of the method's second parameter.
-            /// @tparam arg3_t The type of the method's third parameter.
+            /// @brief Constructor that takes a non-const method with any number of parameters
+            ///
+            /// The object and method are stored as a pair, so Delegates created from the same
+            /// object and method compare equal, and can be removed with -=.
+            /// @tparam object_t The type of the class containing the method to store as the delegate.
+            /// @tparam method_arguments_t The method's parameter types.
             /// @param object The class instance for the method.
             /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t>
+            template<typename object_t, typename... method_arguments_t>
             requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t)) noexcept
+            Delegate(const object_t& object,
+                result_t(object_t::*method)(method_arguments_t...)) noexcept
             {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+                combine(MethodBinding<result_t, object_t, decltype(method)>{
+                    const_cast<object_t*>(&object), method });
             }
-            /// @brief Constructor that takes a non-const method with four parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The type of the method's first parameter.
-            /// @tparam arg2_t The type of the method's second parameter.
-            /// @tparam arg3_t The type of the method's third parameter.
-            /// @tparam arg4_t The type of the method's fourth parameter
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t,
-                typename arg4_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t, 
-                arg4_t)) noexcept
-            {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
-                    std::placeholders::_4));
-            }
-            /// @brief Constructor that takes a non-const method with five parameters
-            /// @tparam object_t The type of the class containing the method to store as a delegate.
-            /// @tparam arg1_t The type of the method's first parameter.
-            /// @tparam arg2_t The type of the method's second parameter.
-            /// @tparam arg3_t The type of the method's third parameter.
-            /// @tparam arg4_t The type of the method's fourth parameter.
-            /// @tparam arg5_t The type of the method's fifth parameter.
-            /// @param object The class instance for the method.
-            /// @param method The method to call.
-            template<typename object_t, typename arg1_t, typename arg2_t, typename arg3_t,
-                typename arg4_t, typename arg5_t>
-            requires std::is_class_v<object_t>
-            Delegate(const object_t& object, result_t(object_t::*method)(arg1_t, arg2_t, arg3_t, 
-                arg4_t, arg5_t)) noexcept
+            /// @brief Destructor
+            ///
+            /// Waiters, such as coroutines waiting for a derived Event, are cancelled.
+            virtual ~Delegate()
             {
-                m_data->functions.push_back(std::bind(method, const_cast<object_t*>(&object),
-                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
-                    std::placeholders::_4, std::placeholders::_5));
+                auto current = m_data.load(std::memory_order_acquire);
+                if (current)
+                {
+                    // A cancelled waiter may wait again, so repeat until none are left.
+                    while (auto waiting = current->waiters.take())
+                    {
+                        while (waiting)
+                        {
+                            auto following = waiting->m_next;
+                            waiting->cancel();
+                            waiting = following;
+                        }
+                    }
+                }
+                delete current;
             }
-            /// @brief Destructor
-            virtual ~Delegate() = default;
             /// @brief Copy equals operator
+            ///
+            /// Like the copy constructor, this shares other's function list in constant time,
+            /// unless other contains functions added with subscribe.
             /// @param other The Delegate object to copy
             /// @return Delegate object that contains a copy of the Delegates in the copied object.
             Delegate& operator =(const Delegate& other)
             {
+                auto functions = detached(other.functions());
+                if (!functions && !m_data.load(std::memory_order_acquire))
+                {
+                    return *this;
+                }
                 std::lock_guard<std::mutex> lock(functionsLock());
-                m_data->functions = other.m_data->functions;
+                publish(std::move(functions));
                 return *this;
             }
             /// @brief Move equals operator
+            ///
+            /// Takes other's function list in constant time. Unlike the move constructor,
+            /// this Delegate keeps its own storage, so that invocations that are running on
+            /// other threads may continue to use it.
             /// @param other The Delegate object to move
             /// @return Delegate object that contains the Delegates in the moved object.
             Delegate& operator =(Delegate&& other)
             {
-                std::lock_guard<std::mutex> lock(functionsLock());
-                m_data->functions = other.m_data->functions;
-                other.m_data->functions.clear();
+                if (this == &other)
+                {
+                    return *this;
+                }
+                auto otherData = other.m_data.load(std::memory_order_acquire);
+                if (!otherData)
+                {
+                    *this = other;
+                    return *this;
+                }
+                std::scoped_lock lock(functionsLock(), otherData->lock);
+                publish(otherData->functions.exchange(nullptr, std::memory_order_acq_rel));
                 return *this;
             }
             /// @brief Remove all functions from the delegate
             void clear()
             {
+                if (!m_data.load(std::memory_order_acquire))
+                {
+                    return;
+                }
                 std::lock_guard<std::mutex> lock(functionsLock());
-                m_data->functions.clear();
+                if (auto current = functions())
+                {
+                    for (const auto& invocation : current->invocations)
+                    {
+                        release(*current, invocation);
+                    }
+                }
+                publish(nullptr);
             }
             /// @brief Return if the delegate is empty.
             /// @return true if delegate is empty, false otherwise.
             bool empty() const noexcept
             {
-                return m_data->functions.empty();
+                return std::ranges::none_of(invocationsOf(functions()), &invocation::live);
             }
             /// @brief Invoke the methods represented by the current delegate.
             /// @param ...args The parameters to pass to each method.
             /// @return The return value from the last method call.
             result_t invoke(arguments_t... args) const
             {
-                return operator ()(args...);
+                return operator ()(std::forward<arguments_t>(args)...);
+            }
+            /// @brief Invoke the methods represented by the current delegate, and fold their
+            /// results with a combiner.
+            ///
+            /// Each result is passed to the combiner as soon as its method returns, so no
+            /// results are stored. If the combiner returns false, the remaining methods are
+            /// not invoked. See the jimo::combiners namespace for the provided combiners.
+            /// @tparam combiner_t The combiner type. It must satisfy jimo::combiners::Combiner.
+            /// @param combiner The combiner.
+            /// @param ...args The parameters to pass to each method.
+            /// @return A copy of the value returned by the combiner's result method. It is
+            /// returned by value so that it outlives a temporary combiner.
+            template<typename combiner_t>
+            requires (!std::is_void_v<result_t>) &&
+                combiners::Combiner<std::remove_cvref_t<combiner_t>, result_t>
+            std::remove_cvref_t<decltype(std::declval<combiner_t&>().result())>
+                invokeWith(combiner_t&& combiner, arguments_t... args) const
+            {
+                auto functions = this->functions();
+                bool dead = false;
+                for (const auto& invocation : invocationsOf(functions))
+                {
+                    auto lock = invocation.lock();
+                    if (!lock)
+                    {
+                        dead = true;
+                    }
+                    else if (!combiner(invocation.call(shareArgument<arguments_t>(args)...)))
+                    {
+                        break;
+                    }
+                }
+                if (dead)
+                {
+                    prune();
+                }
+                return combiner.result();
+            }
+            /// @brief Invoke the methods represented by the current delegate concurrently on
+            /// the threads of a ThreadPool, and wait for all of them to return.
+            ///
+            /// The methods are started in the order they were added, and the calling thread
+            /// also runs methods, so the time taken is roughly that of the slowest method
+            /// rather than the sum of all of them. Results are discarded. The methods must be
+            /// safe to call concurrently with each other. If a method throws, the first
+            /// exception is rethrown after all of the methods have returned.
+            ///
+            /// Because the methods run concurrently, arguments of move-only types must be
+            /// passed by reference.
+            /// @param pool The ThreadPool to run the methods on.
+            /// @param ...args The parameters to pass to each method.
+            void invokeParallel(interthread::ThreadPool& pool, arguments_t... args) const
+            requires ((std::is_reference_v<arguments_t> ||
+                std::is_copy_constructible_v<arguments_t>) && ...)
+            {
+                auto functions = this->functions();
+                auto invocations = invocationsOf(functions);
+                std::atomic<bool> dead = false;
+                pool.parallelFor(invocations.size(), [&invocations, &dead, &args...](size_t index) {
+                    if (auto lock = invocations[index].lock())
+                    {
+                        invocations[index].call(shareArgument<arguments_t>(args)...);
+                    }
+                    else
+                    {
+                        dead.store(true, std::memory_order_relaxed);
+                    }
+                });
+                if (dead)
+                {
+                    prune();
+                }
+            }
+            /// @brief Invoke the methods represented by the current delegate once for each set
+            /// of arguments in a batch.
+            ///
+            /// The function list is retrieved once for the whole batch, rather than once
+            /// per set of arguments. Functions added or removed during the batch take effect
+            /// with the next invocation. Results are discarded. Each function receives the
+            /// arguments in the way operator() passes them to functions other than the last;
+            /// see shareArgument.
+            /// @param batch The arguments for each invocation.
+            /// @param order The order in which to call the functions.
+            void invokeBatch(std::span<std::tuple<arguments_t...>> batch,
+                BatchOrder order = BatchOrder::EventMajor) const
+            {
+                auto functions = this->functions();
+                auto invocations = invocationsOf(functions);
+                bool dead = false;
+                auto call = [&dead](const invocation& invocation, std::tuple<arguments_t...>& arguments) {
+                    if (auto lock = invocation.lock())
+                    {
+                        std::apply([&invocation](auto&... args) {
+                            invocation.call(shareArgument<arguments_t>(args)...);
+                        }, arguments);
+                    }
+                    else
+                    {
+                        dead = true;
+                    }
+                };
+                if (order == BatchOrder::EventMajor)
+                {
+                    for (auto& arguments : batch)
+                    {
+                        for (const auto& invocation : invocations)
+                        {
+                            call(invocation, arguments);
+                        }
+                    }
+                }
+                else
+                {
+                    for (const auto& invocation : invocations)
+                    {
+                        for (auto& arguments : batch)
+                        {
+                            call(invocation, arguments);
+                        }
+                    }
+                }
+                if (dead)
+                {
+                    prune();
+                }
             }
             /// @brief Compare two Delegates for equality
             /// @param other The second Delegate object to compare to this
@@ -305,31 +496,77 @@ namespace jimo
             /// false otherwise.
             bool operator ==(const Delegate& other) const noexcept
             {
-                // const_casts are required so that a lock can be set on m_functionsLock
-                // mutex in each Delegate object. This is required to ensure that
-                // the functions in each Delegate object are not changed while this
-                // method is executing. Once the locks are released, the mutexes are reset
-                // so no changes have been made to either Delegate in this method,
-                // effectively making them const.
-                auto& delegate = const_cast<Delegate&>(*this);
-                auto& oth = const_cast<Delegate&>(other); 
-                std::scoped_lock lock(delegate.functionsLock(), oth.functionsLock());
-                if (delegate.size() != oth.size())
+                // Each snapshot is immutable, so no locks are needed to compare them.
+                auto functions = this->functions();
+                auto otherFunctions = other.functions();
+                if (functions == otherFunctions)
                 {
-                    return false;
+                    return true;
                 }
-                for (size_t index = 0; index < delegate.m_data->functions.size(); ++index)
+                return std::ranges::equal(
+                    invocationsOf(functions) | std::views::filter(&invocation::live),
+                    invocationsOf(otherFunctions) | std::views::filter(&invocation::live),
+                    [](const invocation& left, const invocation& right) {
+                        return left.hash == right.hash && are_equal(left.function, right.function);
+                    });
+            }
+#ifdef JIMO_DELEGATE_INSTRUMENTATION
+            /// @brief Retrieve the dispatch statistics of the functions.
+            ///
+            /// This method is available only when JIMO_DELEGATE_INSTRUMENTATION is defined
+            /// before including any jimo header. Each function's calls are then counted and
+            /// timed with std::chrono::steady_clock. When the macro is not defined, functions
+            /// are called without any instrumentation overhead.
+            /// @return The statistics of each function, in the order they are invoked.
+            std::vector<timing::HandlerStatistics> statistics() const
+            {
+                std::vector<timing::HandlerStatistics> statistics;
+                auto functions = this->functions();
+                for (const auto& invocation : invocationsOf(functions))
                 {
-                    if (!are_equal(delegate.m_data->functions[index], oth.m_data->functions[index]))
+                    if (invocation.live())
                     {
-                        return false;
+                        statistics.push_back(
+                            invocation.counters->statistics(invocation.function.target_type()));
                     }
                 }
-                return true;
+                return statistics;
+            }
+            /// @brief Set the dispatch statistics of all of the functions to zero.
+            ///
+            /// This method is available only when JIMO_DELEGATE_INSTRUMENTATION is defined.
+            void resetStatistics() noexcept
+            {
+                auto functions = this->functions();
+                for (const auto& invocation : invocationsOf(functions))
+                {
+                    invocation.counters->reset();
+                }
+            }
+#endif
+            /// @brief Check if a function is in the Delegate.
+            ///
+            /// Delegates with many functions keep a hash index of them, so this takes
+            /// constant time on average rather than comparing the function with every
+            /// function in the Delegate.
+            /// @param function The function to look for.
+            /// @return true if the Delegate contains a function equal to function, false
+            /// otherwise.
+            bool contains(const function_t& function) const noexcept
+            {
+                auto functions = this->functions();
+                return functions && functions->anyWithHash(function.targetHash(),
+                    [&function](const invocation& invocation) {
+                        return invocation.live() && are_equal(invocation.function, function);
+                    });
             }
             /// @brief Retrieve the number of functions in the Delegate object
             /// @return The number of functions
-            size_t size() { return m_data->functions.size(); }
+            size_t size() const noexcept
+            {
+                return static_cast<size_t>(
+                    std::ranges::count_if(invocationsOf(functions()), &invocation::live));
+            }
             /// @brief Add the function specified by the parameter to this object.
             /// @param function The function to add.
             /// @return The Delegate object (this) that contains the functions that were in
@@ -340,24 +577,106 @@ namespace jimo
                 combine(function);
                 return *this;
             }
+            /// @brief Add a function with a priority to this object.
+            ///
+            /// The invocation list is kept sorted by priority as functions are added, so
+            /// invoking the Delegate does not sort the functions.
+            /// @param function The function and its priority.
+            /// @return The Delegate object (this) that contains the functions that were in
+            /// the original Delegate plus the function specified by the parameter.
+            Delegate& operator +=(const prioritized& function)
+            {
+                std::lock_guard<std::mutex> lock(functionsLock());
+                modify([&function](invocation_list& list) {
+                    insert(list, { function.function, nullptr, 0, 0, {}, false, function.priority });
+                });
+                return *this;
+            }
             /// @brief Add the functions in one Delegate object to this object
+            ///
+            /// The added functions keep their priorities.
             /// @param delegate The Delegate object whose functions are to be added to this object
             /// @return The Delegate object (this) that contains the functions that were originally in
             /// the original Delegate plus the functions in the Delegate object that are being added.
             Delegate& operator +=(const Delegate& delegate)
             {
-                std::lock_guard<std::mutex> lock(m_functionsLock);
+                std::lock_guard<std::mutex> lock(functionsLock());
                 combine(delegate);
                 return *this;
             }
+            /// @brief Start a transaction that applies many additions and removals together.
+            /// @return The transaction. Call its commit method to apply the changes.
+            transaction startTransaction() noexcept
+            {
+                return transaction(*this);
+            }
+            /// @brief Add a function and return a Connection that removes it.
+            ///
+            /// Disconnecting the returned Connection takes constant time, regardless of the
+            /// number of functions in the Delegate. The function is invoked in the same order
+            /// as if it had been added with +=.
+            /// @param function The function to add.
+            /// @return The Connection for the function. Wrap it in a ScopedConnection to remove
+            /// the function automatically.
+            Connection subscribe(const function_t& function)
+            {
+                return connect(function, {}, false, 0);
+            }
+            /// @brief Add a function with a priority and return a Connection that removes it.
+            /// @param function The function and its priority.
+            /// @return The Connection for the function.
+            Connection subscribe(const prioritized& function)
+            {
+                return connect(function.function, {}, false, function.priority);
+            }
+            /// @brief Add a function that is invoked only while an object exists, and return a
+            /// Connection that removes it.
+            ///
+            /// The Delegate holds a std::weak_ptr to target. The object is kept alive while the
+            /// function is running. After the object has been destroyed, the function is no
+            /// longer invoked, and is removed from the Delegate by a later invocation, so it
+            /// does not need to be disconnected.
+            /// @param function The function to add.
+            /// @param target The object that the function uses. If target is empty, the
+            /// function is never invoked.
+            /// @return The Connection for the function.
+            Connection subscribe(const function_t& function, std::weak_ptr<const void> target)
+            {
+                return connect(function, std::move(target), true, 0);
+            }
+            /// @brief Add a method of an object that is owned by a std::shared_ptr, and return
+            /// a Connection that removes it.
+            ///
+            /// The Delegate does not keep the object alive. See
+            /// subscribe(const function_t&, std::weak_ptr<const void>).
+            /// @tparam object_t The type of the class containing the method. It is const for
+            /// const methods.
+            /// @tparam method_t The pointer to member function type of the method.
+            /// @param object The object to call the method on.
+            /// @param method The method to call.
+            /// @return The Connection for the method.
+            template<typename object_t, typename method_t>
+            requires std::is_member_function_pointer_v<method_t> &&
+                std::is_invocable_r_v<result_t, method_t, object_t*, arguments_t...>
+            Connection subscribe(const std::shared_ptr<object_t>& object, method_t method)
+            {
+                return subscribe(MethodBinding<result_t, object_t, method_t>{ object.get(), method },
+                    object);
+            }
             /// @brief Remove the function specified by the parameter from this object.
             /// @param function The function to remove.
             /// @return The Delegate object (this) that contains the functions that were
             /// in the original Delegate object minus the function specified by the parameter.
             Delegate& operator -=(const function_t& function)
             {
+                if (!contains(function))
+                {
+                    return *this;
+                }
                 std::lock_guard<std::mutex> lock(functionsLock());
-                std::erase(m_data->functions, Delegate(function));
+                modify([&function](invocation_list& list) {
+                    remove(list, function);
+                });
                 return *this;
             }
             /// @brief Remove the functions in one Delegate object from this object
@@ -367,83 +686,615 @@ namespace jimo
             /// specified by the parameter
             Delegate& operator -=(const Delegate& delegate)
             {
-                std::lock_guard<std::mutex> lock(functionsLock());
-                for (const auto& function : delegate.m_data->functions)
+                auto removed = delegate.functions();
+                if (!removed)
                 {
-                    std::erase(m_data->functions, Delegate(function));
-
+                    return *this;
                 }
+                std::lock_guard<std::mutex> lock(functionsLock());
+                modify([&removed](invocation_list& list) {
+                    // Look the functions up by hash, rather than comparing every function in
+                    // this Delegate with every function in delegate.
+                    std::unordered_multimap<std::size_t, const function_t*> functions;
+                    for (const auto& invocation : removed->invocations)
+                    {
+                        if (invocation.live())
+                        {
+                            functions.emplace(invocation.hash, &invocation.function);
+                        }
+                    }
+                    std::erase_if(list.invocations, [&list, &functions](const invocation& invocation) {
+                        auto [first, last] = functions.equal_range(invocation.hash);
+                        if (!std::any_of(first, last, [&invocation](const auto& function) {
+                            return are_equal(invocation.function, *function.second); }))
+                        {
+                            return false;
+                        }
+                        release(list, invocation);
+                        return true;
+                    });
+                });
                 return *this;
             }
             /// @brief Invokes the functions in the current Delegate object.
+            ///
+            /// The current snapshot of the functions is retrieved without locking, and
+            /// the functions are called from that snapshot.
+            ///
+            /// Arguments are not copied for functions that take them by reference, and are
+            /// moved into the last function. The other functions receive a copy of each
+            /// argument that they take by value, unless the argument is trivially copyable or
+            /// move-only; see shareArgument. Move-only arguments, such as std::unique_ptr, are
+            /// supported, but only one function should take ownership of each of them.
             /// @return The value returned from executing the last function in the Delegate object.
             virtual result_t operator ()(arguments_t... args) const
             {
-                if (m_data->functions.empty())
+                auto functions = this->functions();
+                auto invocations = invocationsOf(functions);
+                bool dead = false;
+                size_t end = invocations.size();
+                while (end > 0 && !invocations[end - 1].live())
                 {
-                    return result_t();
+                    --end;
+                    dead = true;
                 }
-                std::vector<function_t> functions;
+                for (size_t index = 0; index + 1 < end; ++index)
                 {
-                    // const_cast required so that we can set a lock on m_functionsLock
-                    // to prevent any changes to the functions list while copying.
-                    // The mutex is reset when the lock goes out of scope, and no other
-                    // changes are made to this, so on exit, no changes have been made
-                    // to this Delegate.
-                    auto& delegate = const_cast<Delegate&>(*this);
-                    std::lock_guard<std::mutex> lock(delegate.functionsLock());
-                    functions = delegate.m_data->functions;
+                    if (auto lock = invocations[index].lock())
+                    {
+                        invocations[index].call(shareArgument<arguments_t>(args)...);
+                    }
+                    else
+                    {
+                        dead = true;
+                    }
                 }
-                for (size_t index = 0; index < functions.size() - 1; ++index)
+                if (dead)
                 {
-                    functions[index](args...);
+                    prune();
                 }
-                if (std::is_void_v<result_t>)
+                if (end == 0)
                 {
-                    functions[functions.size() -1](args...);
+                    return result_t();
                 }
-                else
+                // The last function's target may have been destroyed since it was checked.
+                auto lock = invocations[end - 1].lock();
+                if (!lock)
                 {
-                    return functions[functions.size() -1](args...);
+                    return result_t();
                 }
+                return invocations[end - 1].call(std::forward<arguments_t>(args)...);
             }
+        private:
+            struct waiter_list;
         protected:
-            /// @brief Retrieve the delegate functions.
+            /// @brief A function in a Delegate's invocation list.
+            struct invocation
+            {
+                /// @brief The function to call.
+                function_t function;
+                /// @brief The generation count of the function's connection slot, or nullptr
+                /// if the function was not added with subscribe.
+                const std::atomic<std::uint32_t>* slotGeneration = nullptr;
+                /// @brief The index of the function's connection slot.
+                std::uint32_t slotIndex = 0;
+                /// @brief The generation of the connection slot when the function was added.
+                std::uint32_t generation = 0;
+                /// @brief The object that the function calls, if the function was added with
+                /// a tracked subscribe.
+                std::weak_ptr<const void> target {};
+                /// @brief true if the function is called only while target exists.
+                bool tracked = false;
+                /// @brief The function's priority. Functions with higher priorities are
+                /// invoked first.
+                int priority = 0;
+                /// @brief The targetHash of the function. It is set when the function is added.
+                std::size_t hash = 0;
+#ifdef JIMO_DELEGATE_INSTRUMENTATION
+                /// @brief The function's dispatch statistics. The copies of an invocation in
+                /// later snapshots share them.
+                std::shared_ptr<timing::HandlerCounters> counters =
+                    std::make_shared<timing::HandlerCounters>();
+#endif
+                /// @brief Call the function, and record the call if
+                /// JIMO_DELEGATE_INSTRUMENTATION is defined.
+                /// @param ...args The arguments to pass to the function.
+                /// @return The value returned by the function.
+                result_t call(arguments_t&&... args) const
+                {
+#ifdef JIMO_DELEGATE_INSTRUMENTATION
+                    timing::HandlerTimer timer(*counters);
+#endif
+                    return function.call(std::forward<arguments_t>(args)...);
+                }
+                /// @brief Keeps the target of a function alive while the function is called.
+                struct target_lock
+                {
+                    /// @brief The target, or nullptr if the function does not track a target.
+                    std::shared_ptr<const void> target;
+                    /// @brief true if the function should be called.
+                    bool live;
+                    /// @brief Check if the function should be called.
+                    explicit operator bool() const noexcept { return live; }
+                };
+                /// @brief Check if the function has not been disconnected, and its target, if
+                /// it tracks one, has not been destroyed.
+                /// @return true if the function should be called, false otherwise.
+                bool live() const noexcept
+                {
+                    return connected() && (!tracked || !target.expired());
+                }
+                /// @brief Check if the function should be called, and keep its target alive
+                /// until the returned lock is destroyed.
+                ///
+                /// This method does not lock the Delegate, and never blocks.
+                /// @return A lock that converts to true if the function should be called.
+                target_lock lock() const noexcept
+                {
+                    if (!connected())
+                    {
+                        return { nullptr, false };
+                    }
+                    if (!tracked)
+                    {
+                        return { nullptr, true };
+                    }
+                    auto locked = target.lock();
+                    bool live = locked != nullptr;
+                    return { std::move(locked), live };
+                }
+            private:
+                bool connected() const noexcept
+                {
+                    return !slotGeneration ||
+                        slotGeneration->load(std::memory_order_acquire) == generation;
+                }
+            };
+            /// @brief An immutable snapshot of the functions in a Delegate.
+            struct invocation_list
+            {
+                /// @brief The functions, in the order they are invoked.
+                std::vector<invocation> invocations;
+                /// @brief The slot table for the functions added with subscribe, or nullptr
+                /// if no function was added with subscribe.
+                std::shared_ptr<ConnectionSlots> slots;
+                /// @brief An open addressing hash table of the invocations, keyed by their
+                /// hashes. Each entry is an index into invocations plus one, or 0 if the entry
+                /// is unused. The table is empty if there are fewer than indexThreshold
+                /// invocations. Functions whose targets cannot be hashed have a hash of 0, and
+                /// are left out of the table, so that they do not form one long probe sequence.
+                std::vector<std::uint32_t> index;
+                /// @brief Call a function for each invocation whose hash is hash, until it
+                /// returns true.
+                /// @param hash The hash to look for.
+                /// @param predicate The function to call.
+                /// @return true if predicate returned true, false otherwise.
+                template<typename predicate_t>
+                bool anyWithHash(std::size_t hash, predicate_t predicate) const
+                {
+                    if (index.empty() || hash == 0)
+                    {
+                        return std::ranges::any_of(invocations,
+                            [hash, &predicate](const invocation& invocation) {
+                                return invocation.hash == hash && predicate(invocation);
+                            });
+                    }
+                    auto mask = index.size() - 1;
+                    for (auto entry = hash & mask; index[entry] != 0; entry = (entry + 1) & mask)
+                    {
+                        const auto& invocation = invocations[index[entry] - 1];
+                        if (invocation.hash == hash && predicate(invocation))
+                        {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+            };
+            /// @brief The number of functions at which a Delegate starts to keep a hash index
+            /// of its functions.
+            static constexpr std::size_t indexThreshold = 32;
+            /// @brief Retrieve the current snapshot of the delegate functions.
             ///
             /// This method is provided so that derived classes can access the functions.
-            /// @return functions stored in this Delegate.
-            std::vector<function_t>& functions() { return m_data->functions; }
-            /// @brief REetrieve the delegate functions.
+            /// The snapshot is never modified; +=, -=, and clear publish a new snapshot
+            /// instead, so it may be iterated without holding the functionsLock mutex.
+            /// Functions that are not live() have been disconnected, or their targets have
+            /// been destroyed, and must be skipped. Call the function only while holding the
+            /// lock returned by invocation::lock(), and call prune() after skipping one.
+            /// @return functions stored in this Delegate, or nullptr if the Delegate is empty.
+            std::shared_ptr<const invocation_list> functions() const noexcept
+            {
+                auto current = m_data.load(std::memory_order_acquire);
+                if (!current)
+                {
+                    return nullptr;
+                }
+                return current->functions.load(std::memory_order_acquire);
+            }
+            /// @brief Retrieve the invocations in a snapshot.
+            /// @param functions The snapshot returned by functions().
+            /// @return The invocations, or an empty span if functions is nullptr.
+            static std::span<const invocation> invocationsOf(
+                const std::shared_ptr<const invocation_list>& functions) noexcept
+            {
+                if (!functions)
+                {
+                    return {};
+                }
+                return functions->invocations;
+            }
+            /// @brief Remove the functions that are no longer live from the invocation list.
             ///
-            /// This method is provided so that derived classes can access the functions.
-             /// @return functions stored in this Delegate.
-            std::vector<function_t>& functions() const { return m_data->functions; }
-            /// @brief Retrieve the functionsLock mutex.ved classes can access the mutex.
+            /// Invocations call this method after they skip a function that is not live. It
+            /// does nothing if another thread holds the functionsLock mutex, because that
+            /// thread's change also removes the functions that are not live.
+            void prune() const
+            {
+                auto current = m_data.load(std::memory_order_acquire);
+                if (!current)
+                {
+                    return;
+                }
+                std::unique_lock<std::mutex> lock(current->lock, std::try_to_lock);
+                if (lock.owns_lock())
+                {
+                    // Only the shared data is changed, so this is safe for const Delegates.
+                    const_cast<Delegate*>(this)->modify([](invocation_list&) {});
+                }
+            }
+            /// @brief Something, usually a suspended coroutine, that waits for a derived class to
+            /// fire.
+            ///
+            /// Waiters are kept in an intrusive list, so waiting never allocates memory. A waiter
+            /// that is destroyed before it is resumed removes itself from the list. A waiter must
+            /// not be destroyed while the Delegate that it waits on is firing or being destroyed
+            /// on another thread.
+            struct waiter
+            {
+                /// @brief Called once, when the derived class next fires.
+                ///
+                /// The waiter may be destroyed by this call.
+                /// @param ...args The arguments that the derived class fired with.
+                virtual void resume(arguments_t... args) = 0;
+                /// @brief Called once, instead of resume, if the Delegate is destroyed while
+                /// the waiter is waiting.
+                ///
+                /// The waiter may be destroyed by this call.
+                virtual void cancel() noexcept = 0;
+            protected:
+                /// @brief Constructor
+                waiter() = default;
+                /// @brief Copy constructor
+                waiter(const waiter&) = delete;
+                /// @brief Destructor. Removes the waiter from the list that it is in.
+                ~waiter()
+                {
+                    if (auto list = m_list.load(std::memory_order_acquire))
+                    {
+                        list->remove(this);
+                    }
+                }
+                /// @brief Copy equals operator
+                waiter& operator =(const waiter&) = delete;
+            private:
+                friend class Delegate;
+                friend struct waiter_list;
+
+                std::atomic<waiter_list*> m_list { nullptr };
+                waiter* m_next = nullptr;
+                waiter* m_previous = nullptr;
+            };
+            /// @brief Add a waiter that is to be resumed the next time a derived class fires.
+            ///
+            /// This method does not lock the functionsLock mutex, so it may be called while
+            /// the Delegate is being invoked or modified.
+            /// @param added The waiter. It is resumed or cancelled once, unless it is
+            /// destroyed first.
+            void addWaiter(waiter* added)
+            {
+                state().waiters.add(added);
+            }
+            /// @brief Resume all of the waiters, oldest first.
+            ///
+            /// Waiters that are added while the waiters are being resumed wait for the next
+            /// time that the derived class fires.
+            /// @param ...args The arguments to pass to each waiter.
+            void resumeWaiters(arguments_t... args) const
+            {
+                auto current = m_data.load(std::memory_order_acquire);
+                auto waiting = current ? current->waiters.take() : nullptr;
+                while (waiting)
+                {
+                    auto following = waiting->m_next;
+                    waiting->resume(args...);
+                    waiting = following;
+                }
+            }
+            /// @brief Retrieve the functionsLock mutex.
             ///
             /// This method is provided so that derived classes can access the mutex.
+            /// The mutex serializes changes to the functions; it is not held while invoking them.
+            /// It is created, along with the rest of the Delegate's storage, the first time
+            /// that this method is called or that a function is added.
             /// @return the functionsLock mutex.
-            std::mutex& functionsLock() { return m_functionsLock; }
+            std::mutex& functionsLock() { return state().lock; }
         private:
-            static bool are_equal(const function_t& left, const function_t& right)
+            Connection connect(const function_t& function, std::weak_ptr<const void> target,
+                bool tracked, int priority)
+            {
+                std::lock_guard<std::mutex> lock(functionsLock());
+                Connection connection;
+                modify([&function, &target, tracked, priority, &connection](invocation_list& list) {
+                    if (!list.slots)
+                    {
+                        list.slots = std::make_shared<ConnectionSlots>();
+                    }
+                    auto slot = list.slots->acquire();
+                    insert(list, { function, slot.current, slot.index, slot.generation,
+                        std::move(target), tracked, priority });
+                    connection = Connection(list.slots, slot);
+                });
+                return connection;
+            }
+            // Insert a function after all functions with the same or higher priority.
+            static void insert(invocation_list& list, invocation added)
+            {
+                added.hash = added.function.targetHash();
+                auto position = std::ranges::upper_bound(list.invocations, added.priority,
+                    std::ranges::greater(), &invocation::priority);
+                list.invocations.insert(position, std::move(added));
+            }
+            static bool are_equal(const function_t& left, const function_t& right) noexcept
+            {
+                return left.sameTarget(right);
+            }
+            // Release the connection slot of a function that is being removed, so that its
+            // Connection reports that it is no longer connected.
+            static void release(const invocation_list& list, const invocation& invocation) noexcept
+            {
+                if (invocation.slotGeneration)
+                {
+                    list.slots->release(invocation.slotIndex, invocation.generation);
+                }
+            }
+            static void remove(invocation_list& list, const function_t& function)
+            {
+                auto hash = function.targetHash();
+                std::erase_if(list.invocations, [&list, &function, hash](const invocation& invocation) {
+                    if (invocation.hash != hash || !are_equal(invocation.function, function))
+                    {
+                        return false;
+                    }
+                    release(list, invocation);
+                    return true;
+                });
+            }
+            // The functionsLock mutex must be held, or the Delegate must still be under
+            // construction, when calling publish, modify, or combine.
+            void publish(std::shared_ptr<const invocation_list> functions)
             {
-                return left.target_type() == right.target_type() && 
-                    (left.template target<result_t(*)(arguments_t...)>() == right.template target<result_t(*)(arguments_t...)>()
-                    || *left.template target<result_t(*)(arguments_t...)>() == *right.template target<result_t(*)(arguments_t...)>());
+                if (!functions && !m_data.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                state().functions.store(std::move(functions), std::memory_order_release);
+            }
+            // Build a new snapshot from the current one, without the functions that have been
+            // disconnected or whose targets have been destroyed, apply modifier to it, and
+            // publish it.
+            template<typename modifier_t>
+            void modify(modifier_t modifier)
+            {
+                auto current = functions();
+                auto updated = std::make_shared<invocation_list>();
+                if (current)
+                {
+                    updated->slots = current->slots;
+                    updated->invocations.reserve(current->invocations.size() + 1);
+                    for (const auto& invocation : current->invocations)
+                    {
+                        if (invocation.live())
+                        {
+                            updated->invocations.push_back(invocation);
+                        }
+                        else
+                        {
+                            // The target of a tracked function has been destroyed.
+                            release(*current, invocation);
+                        }
+                    }
+                }
+                modifier(*updated);
+                if (updated->invocations.size() >= indexThreshold)
+                {
+                    buildIndex(*updated);
+                }
+                if (updated->invocations.empty())
+                {
+                    publish(nullptr);
+                }
+                else
+                {
+                    publish(std::move(updated));
+                }
+            }
+            static void buildIndex(invocation_list& list)
+            {
+                // At most half of the entries are used, so that probe sequences stay short.
+                list.index.assign(std::bit_ceil(2 * list.invocations.size()), 0);
+                auto mask = list.index.size() - 1;
+                for (std::size_t position = 0; position < list.invocations.size(); ++position)
+                {
+                    if (list.invocations[position].hash == 0)
+                    {
+                        continue;
+                    }
+                    auto entry = list.invocations[position].hash & mask;
+                    while (list.index[entry] != 0)
+                    {
+                        entry = (entry + 1) & mask;
+                    }
+                    list.index[entry] = static_cast<std::uint32_t>(position + 1);
+                }
+            }
+            // Copy a function list for another Delegate. Functions added with subscribe are
+            // copied without their connection slots, so that disconnecting or removing them
+            // in one Delegate does not affect the other. Lists without such functions are
+            // shared.
+            static std::shared_ptr<const invocation_list> detached(
+                std::shared_ptr<const invocation_list> functions)
+            {
+                if (!functions || !functions->slots)
+                {
+                    return functions;
+                }
+                auto copy = std::make_shared<invocation_list>();
+                copy->invocations.reserve(functions->invocations.size());
+                for (const auto& invocation : functions->invocations)
+                {
+                    if (invocation.live())
+                    {
+                        auto& added = copy->invocations.emplace_back(invocation);
+                        added.slotGeneration = nullptr;
+                        added.slotIndex = 0;
+                        added.generation = 0;
+                    }
+                }
+                if (copy->invocations.empty())
+                {
+                    return nullptr;
+                }
+                if (copy->invocations.size() >= indexThreshold)
+                {
+                    buildIndex(*copy);
+                }
+                return copy;
             }
             void combine(const Delegate& other)
             {
-                std::ranges::copy(other.functions(), std::back_inserter(functions()));
+                auto added = other.functions();
+                if (added)
+                {
+                    modify([&added](invocation_list& list) {
+                        for (const auto& invocation : added->invocations)
+                        {
+                            if (!invocation.live())
+                            {
+                                continue;
+                            }
+                            // Connections made on another Delegate only control that Delegate.
+                            if (invocation.slotGeneration && added->slots == list.slots)
+                            {
+                                insert(list, invocation);
+                            }
+                            else
+                            {
+                                insert(list, { invocation.function, nullptr, 0, 0,
+                                    invocation.target, invocation.tracked, invocation.priority });
+                            }
+                        }
+                    });
+                }
             }
             void combine(const function_t& function)
             {
-                m_data->functions.push_back(function);
+                modify([&function](invocation_list& list) {
+                    insert(list, { function });
+                });
             }
+            // The waiters, oldest first. The links are only changed while lock is held.
+            struct waiter_list
+            {
+                void add(waiter* added)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    added->m_next = nullptr;
+                    added->m_previous = last;
+                    if (last)
+                    {
+                        last->m_next = added;
+                    }
+                    else
+                    {
+                        first.store(added, std::memory_order_relaxed);
+                    }
+                    last = added;
+                    added->m_list.store(this, std::memory_order_release);
+                }
+                void remove(waiter* removed)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    // The waiter may have been taken since the caller checked.
+                    if (removed->m_list.load(std::memory_order_relaxed) != this)
+                    {
+                        return;
+                    }
+                    if (removed->m_previous)
+                    {
+                        removed->m_previous->m_next = removed->m_next;
+                    }
+                    else
+                    {
+                        first.store(removed->m_next, std::memory_order_relaxed);
+                    }
+                    if (removed->m_next)
+                    {
+                        removed->m_next->m_previous = removed->m_previous;
+                    }
+                    else
+                    {
+                        last = removed->m_previous;
+                    }
+                    removed->m_list.store(nullptr, std::memory_order_relaxed);
+                }
+                // Remove all of the waiters, and return them linked by m_next.
+                waiter* take()
+                {
+                    if (!first.load(std::memory_order_relaxed))
+                    {
+                        return nullptr;
+                    }
+                    std::lock_guard<std::mutex> guard(lock);
+                    auto taken = first.exchange(nullptr, std::memory_order_relaxed);
+                    for (auto waiting = taken; waiting; waiting = waiting->m_next)
+                    {
+                        waiting->m_list.store(nullptr, std::memory_order_relaxed);
+                    }
+                    last = nullptr;
+                    return taken;
+                }
+
+                std::mutex lock;
+                std::atomic<waiter*> first { nullptr };
+                waiter* last = nullptr;
+            };
             struct data
             {
-                std::vector<function_t> functions;
+                std::atomic<std::shared_ptr<const invocation_list>> functions;
+                std::mutex lock;
+                waiter_list waiters;
             };
-            std::shared_ptr<data> m_data = std::make_shared<data>();
-            std::mutex m_functionsLock;
-            
+            // Retrieve the storage, creating it if this Delegate has never held a function.
+            data& state() const
+            {
+                auto current = m_data.load(std::memory_order_acquire);
+                if (!current)
+                {
+                    auto created = std::make_unique<data>();
+                    if (m_data.compare_exchange_strong(current, created.get(),
+                        std::memory_order_acq_rel, std::memory_order_acquire))
+                    {
+                        current = created.release();
+                    }
+                }
+                return *current;
+            }
+            // The storage is allocated on first use, so a Delegate that is never subscribed to
+            // holds only this pointer.
+            mutable std::atomic<data*> m_data { nullptr };
     };
+
+    static_assert(sizeof(Delegate<void>) == 2 * sizeof(void*),
+        "A Delegate must contain only its vtable pointer and a pointer to its storage.");
 }
\ No newline at end of file
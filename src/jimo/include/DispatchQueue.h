@@ -0,0 +1,209 @@
+/// @file DispatchQueue.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Executor.h"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace jimo::interthread
+{
+    /// @brief An Executor that runs tasks one at a time, in the order they are posted, on a
+    /// single dispatcher thread.
+    ///
+    /// Posting is lock-free: a task is moved into a slot of a fixed size ring buffer with one
+    /// atomic compare and exchange, and no memory is allocated. Any number of threads may post
+    /// tasks. The dispatcher thread removes all of the tasks that are waiting, up to
+    /// maxBatch() at a time, and frees their slots before running them, so producers
+    /// rarely wait for slots while the tasks run. The dispatcher thread sleeps when there
+    /// are no tasks, and a producer only wakes it if it is sleeping.
+    ///
+    /// If the queue is full, post waits until the dispatcher thread frees a slot; tryPost
+    /// returns false instead. Tasks that have been posted when the DispatchQueue is destroyed
+    /// are run before the destructor returns. Tasks must not throw exceptions.
+    class DispatchQueue : public Executor
+    {
+        public:
+            /// @brief Constructor
+            /// @param capacity The number of tasks that can be waiting. It is rounded up to
+            /// a power of two.
+            /// @param maxBatch The largest number of tasks that the dispatcher thread removes
+            /// from the queue at once.
+            /// @exception std::invalid_argument if capacity or maxBatch is zero.
+            explicit DispatchQueue(std::size_t capacity = 4096, std::size_t maxBatch = 256)
+                : m_mask(std::bit_ceil(checked(capacity, "capacity")) - 1), m_maxBatch(checked(maxBatch, "maxBatch")),
+                m_cells(std::make_unique<cell[]>(m_mask + 1))
+            {
+                for (std::size_t index = 0; index <= m_mask; ++index)
+                {
+                    m_cells[index].sequence.store(index, std::memory_order_relaxed);
+                }
+                m_dispatcher = std::jthread([this](std::stop_token stopToken) {
+                    runTasks(stopToken);
+                });
+            }
+            /// @brief Copy constructor
+            DispatchQueue(const DispatchQueue&) = delete;
+            /// @brief Move constructor
+            DispatchQueue(DispatchQueue&&) = delete;
+            /// @brief Destructor. Runs the tasks that are waiting, then joins the dispatcher
+            /// thread.
+            virtual ~DispatchQueue() noexcept
+            {
+                m_dispatcher.request_stop();
+                // Pairs with the fence in runTasks, so that the dispatcher thread either sees
+                // the stop request or is woken.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                wake();
+                m_dispatcher.join();
+            }
+            /// @brief Copy equals operator
+            DispatchQueue& operator =(const DispatchQueue&) = delete;
+            /// @brief Move equals operator
+            DispatchQueue& operator =(DispatchQueue&&) = delete;
+            /// @brief Post a task to be run on the dispatcher thread.
+            ///
+            /// If the queue is full, this method waits until there is room for the task.
+            /// It must not be called by a task when the queue may be full.
+            /// @param task The task to run.
+            void post(task_t task) override
+            {
+                while (!tryPost(task))
+                {
+                    std::this_thread::yield();
+                }
+            }
+            /// @brief Post a task to be run on the dispatcher thread, if there is room for it.
+            /// @param task The task to run. It is moved from only if this method returns true.
+            /// @return true if the task was posted, false if the queue is full.
+            bool tryPost(task_t& task)
+            {
+                auto position = m_tail.load(std::memory_order_relaxed);
+                cell* slot;
+                while (true)
+                {
+                    slot = &m_cells[position & m_mask];
+                    auto sequence = slot->sequence.load(std::memory_order_acquire);
+                    auto difference = static_cast<std::intptr_t>(sequence - position);
+                    if (difference == 0)
+                    {
+                        if (m_tail.compare_exchange_weak(position, position + 1,
+                            std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = m_tail.load(std::memory_order_relaxed);
+                    }
+                }
+                slot->task = std::move(task);
+                slot->sequence.store(position + 1, std::memory_order_release);
+                // Pairs with the fence in runTasks, so that either the dispatcher thread sees
+                // the task, or this thread sees that the dispatcher thread is sleeping.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_sleeping.load(std::memory_order_relaxed))
+                {
+                    wake();
+                }
+                return true;
+            }
+            /// @brief Retrieve the number of tasks that can be waiting.
+            /// @return The capacity of the queue.
+            std::size_t capacity() const noexcept { return m_mask + 1; }
+            /// @brief Retrieve the largest number of tasks that are removed from the queue at once.
+            /// @return The maximum batch size.
+            std::size_t maxBatch() const noexcept { return m_maxBatch; }
+        private:
+            struct cell
+            {
+                std::atomic<std::size_t> sequence;
+                task_t task;
+            };
+            static std::size_t checked(std::size_t value, const char* name)
+            {
+                if (value == 0)
+                {
+                    throw std::invalid_argument(std::string("DispatchQueue ") + name +
+                        " must not be zero.");
+                }
+                return value;
+            }
+            void wake() noexcept
+            {
+                if (m_sleeping.exchange(false, std::memory_order_acq_rel))
+                {
+                    m_sleeping.notify_one();
+                }
+            }
+            // Move up to maxBatch waiting tasks into batch, and free their slots.
+            void take(std::vector<task_t>& batch)
+            {
+                while (batch.size() < m_maxBatch)
+                {
+                    auto& slot = m_cells[m_head & m_mask];
+                    if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+                    {
+                        return;
+                    }
+                    batch.push_back(std::move(slot.task));
+                    slot.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+                    ++m_head;
+                }
+            }
+            void runTasks(std::stop_token stopToken)
+            {
+                std::vector<task_t> batch;
+                batch.reserve(m_maxBatch);
+                while (true)
+                {
+                    take(batch);
+                    if (batch.empty())
+                    {
+                        if (stopToken.stop_requested())
+                        {
+                            return;
+                        }
+                        m_sleeping.store(true, std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        take(batch);
+                        if (batch.empty() && !stopToken.stop_requested())
+                        {
+                            m_sleeping.wait(true, std::memory_order_acquire);
+                        }
+                        m_sleeping.store(false, std::memory_order_relaxed);
+                        continue;
+                    }
+                    for (auto& task : batch)
+                    {
+                        task();
+                    }
+                    batch.clear();
+                }
+            }
+
+            const std::size_t m_mask;
+            const std::size_t m_maxBatch;
+            std::unique_ptr<cell[]> m_cells;
+            // The producers and the dispatcher thread update these separately, so keep
+            // them on different cache lines.
+            alignas(64) std::atomic<std::size_t> m_tail { 0 };
+            alignas(64) std::size_t m_head { 0 };
+            std::atomic<bool> m_sleeping { false };
+            std::jthread m_dispatcher;
+    };
+}
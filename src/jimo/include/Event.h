@@ -6,7 +6,16 @@
 #include "EventArgs.h"
 #include "Object.h"
 #include "EventHandler.h"
+#include "Executor.h"
+#include <atomic>
 #include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 
 namespace jimo
@@ -25,8 +34,24 @@ namespace jimo
         public:
             /// @brief Constructor
             Event() = default;
+            /// @brief Copy constructor
+            ///
+            /// The copy shares other's handlers until either Event is modified.
+            /// @param other The Event to copy.
+            Event(const Event& other) = default;
+            /// @brief Move constructor
+            /// @param other The Event to move. It is empty after the move.
+            Event(Event&& other) noexcept = default;
             /// @brief Destructor
             virtual ~Event() noexcept = default;
+            /// @brief Copy equals operator
+            /// @param other The Event to copy.
+            /// @return This Event.
+            Event& operator =(const Event& other) = default;
+            /// @brief Move equals operator
+            /// @param other The Event to move. It is empty after the move.
+            /// @return This Event.
+            Event& operator =(Event&& other) = default;
             /// @brief Compare two Event objects for equality.
             /// @param other The Event object to compare with this.
             /// @return <code>true</code> if the objects are equal, <code>false</code> otherwise.
@@ -34,6 +59,180 @@ namespace jimo
             {
                 return *this == other;
             }
+            using EventHandler<sender_t, eventArgs_t>::operator +=;
+            using EventHandler<sender_t, eventArgs_t>::subscribe;
+            /// @brief The size, in bytes, of the largest event args that can be posted to an
+            /// executor by post or by a method added with an executor.
+            ///
+            /// The posted task stores a copy of the args, together with the sender and the
+            /// method, in interthread::executorTaskCapacity bytes. To post larger args, make
+            /// them smaller, for example by holding large members through a pointer.
+            static constexpr std::size_t maxPostedArgsSize =
+                interthread::executorTaskCapacity - 2 * alignof(std::max_align_t);
+            /// @brief A method and the executor to call it on.
+            ///
+            /// This allows a method to be added with
+            /// <code>event += { function, executor };</code>
+            struct affine
+            {
+                /// @brief The method to add.
+                typename EventHandler<sender_t, eventArgs_t>::function_t function;
+                /// @brief The executor that the method is called on. It must outlive the
+                /// method's subscription and the tasks posted to it.
+                interthread::Executor& executor;
+            };
+            /// @brief Add a method that is called on an executor rather than on the invoking
+            /// thread.
+            ///
+            /// When the Event is invoked, a task that calls the method with the sender and a
+            /// copy of the event args is posted to the executor. Methods added without an
+            /// executor are still called directly, in order, on the invoking thread. Because the
+            /// method runs after the invocation returns, it cannot halt the event, and changes
+            /// that it makes to the args are not seen by the other methods. The sender must
+            /// outlive the task.
+            ///
+            /// Each invocation posts one task for each such method. To wake the executor's
+            /// thread once for a burst of invocations, rather than once for each, wrap it in
+            /// a jimo::interthread::BatchingExecutor.
+            ///
+            /// eventArgs_t must be no larger than maxPostedArgsSize bytes.
+            ///
+            /// The method cannot be removed with -=; use subscribe(const affine&) and its
+            /// Connection, or clear, to remove it.
+            /// @param function The method and its executor.
+            /// @return This Event.
+            Event& operator +=(const affine& function)
+                requires std::copy_constructible<eventArgs_t>
+            {
+                *this += handOff(function);
+                return *this;
+            }
+            /// @brief Add a method that is called on an executor, and return a Connection that
+            /// removes it.
+            /// @see operator +=(const affine&)
+            /// @param function The method and its executor.
+            /// @return The Connection for the method. Disconnecting it does not cancel tasks
+            /// that have already been posted.
+            Connection subscribe(const affine& function)
+                requires std::copy_constructible<eventArgs_t>
+            {
+                return subscribe(handOff(function));
+            }
+            /// @brief The result of awaiting an Event.
+            struct occurrence
+            {
+                /// @brief The object that fired the Event.
+                sender_t& sender;
+                /// @brief A copy of the event args that the Event was fired with.
+                eventArgs_t args;
+            };
+            /// @brief An awaitable that suspends a coroutine until the next time an Event fires.
+            ///
+            /// The awaiter is stored in the coroutine's frame and linked into the Event's list
+            /// of waiters, so a waiting coroutine costs no thread and no memory allocation.
+            /// Destroying a suspended coroutine removes its awaiter from the list.
+            /// Create awaiters with Event::next or <code>co_await event</code>.
+            class awaiter : private EventHandler<sender_t, eventArgs_t>::waiter
+            {
+                public:
+                    /// @brief Construct an awaiter.
+                    /// @param event The Event to wait for.
+                    /// @param executor The executor to resume the coroutine on, or nullptr to
+                    /// resume it on the thread that fires the Event.
+                    awaiter(Event& event, interthread::Executor* executor) noexcept
+                        : m_event(event), m_executor(executor) {}
+                    /// @brief The coroutine always waits for the next time the Event fires.
+                    /// @return false
+                    bool await_ready() const noexcept { return false; }
+                    /// @brief Add the coroutine to the Event's waiters.
+                    /// @param handle The suspended coroutine.
+                    void await_suspend(std::coroutine_handle<> handle)
+                    {
+                        m_handle = handle;
+                        // The coroutine may be resumed, and this awaiter destroyed, by another
+                        // thread as soon as it is added, so nothing may follow this call.
+                        m_event.addWaiter(this);
+                    }
+                    /// @brief Retrieve the sender and event args that the Event fired with.
+                    /// @return The occurrence.
+                    /// @exception std::runtime_error if the Event was destroyed while the
+                    /// coroutine was waiting for it.
+                    occurrence await_resume()
+                    {
+                        if (!m_sender)
+                        {
+                            throw std::runtime_error("The Event was destroyed while a coroutine "
+                                "was waiting for it.");
+                        }
+                        return { *m_sender, std::move(*m_args) };
+                    }
+                private:
+                    void resume(sender_t& sender, eventArgs_t& e) override
+                    {
+                        m_sender = &sender;
+                        m_args.emplace(e);
+                        wake();
+                    }
+                    void cancel() noexcept override
+                    {
+                        wake();
+                    }
+                    void wake()
+                    {
+                        if (m_executor)
+                        {
+                            m_executor->post([handle = m_handle]() { handle.resume(); });
+                        }
+                        else
+                        {
+                            m_handle.resume();
+                        }
+                    }
+
+                    Event& m_event;
+                    interthread::Executor* m_executor;
+                    std::coroutine_handle<> m_handle;
+                    sender_t* m_sender = nullptr;
+                    std::optional<eventArgs_t> m_args;
+            };
+            /// @brief Wait for the next time that this Event fires.
+            ///
+            /// <code>auto [sender, e] = co_await event.next();</code> suspends the coroutine
+            /// until the Event is next invoked, and then resumes it on the invoking thread,
+            /// after the methods have been called, whether or not one of them halted the
+            /// event. <code>co_await event</code> is equivalent.
+            ///
+            /// The coroutine receives a copy of the event args, so that it may be resumed
+            /// after the invocation returns. The sender must outlive the coroutine's use of it.
+            /// If the Event is destroyed while the coroutine is waiting, the coroutine is
+            /// resumed, on the destroying thread or the executor, and co_await throws
+            /// std::runtime_error. A waiting coroutine may be destroyed, unless the Event is
+            /// firing on another thread.
+            /// @return The awaiter.
+            awaiter next() requires std::copy_constructible<eventArgs_t>
+            {
+                return awaiter(*this, nullptr);
+            }
+            /// @brief Wait for the next time that this Event fires, and resume on an executor.
+            ///
+            /// This is the same as next(), except that the coroutine is posted to executor
+            /// instead of being resumed on the invoking thread, so a slow coroutine does not
+            /// delay the invocation.
+            /// @param executor The executor to resume the coroutine on, for example a
+            /// ThreadPool. It must outlive the wait.
+            /// @return The awaiter.
+            awaiter next(interthread::Executor& executor)
+                requires std::copy_constructible<eventArgs_t>
+            {
+                return awaiter(*this, &executor);
+            }
+            /// @brief Wait for the next time that this Event fires.
+            /// @see next()
+            /// @return The awaiter.
+            awaiter operator co_await() requires std::copy_constructible<eventArgs_t>
+            {
+                return next();
+            }
             /// @brief Invoke the methods represented by the current event.
             /// @param sender The object that called invoke.
             /// @param e an event args object. It must be derived from EventArgs.
@@ -41,26 +240,166 @@ namespace jimo
             {
                 operator ()(sender, e);
             }
-            /// @brief Invoke the methods represented by the current event.
+            /// @brief Invoke the methods represented by the current event asynchronously.
+            ///
+            /// A copy of e is posted to executor, which invokes the methods with it later, so
+            /// the caller pays only for the copy and the post, however slow the methods are.
+            /// With a jimo::interthread::DispatchQueue, posting is lock-free and the methods are
+            /// called on the queue's dispatcher thread, in the order that the events are posted.
+            /// The Event and sender must remain valid until the methods have been called.
+            /// eventArgs_t must be no larger than maxPostedArgsSize bytes.
+            /// @param executor The executor that invokes the methods.
+            /// @param sender The object that called post.
+            /// @param e an event args object. It must be derived from EventArgs.
+            void post(interthread::Executor& executor, sender_t& sender, const eventArgs_t& e)
+                requires std::copy_constructible<eventArgs_t>
+            {
+                static_assert(sizeof(eventArgs_t) <= maxPostedArgsSize,
+                    "The event args are larger than Event::maxPostedArgsSize.");
+                executor.post([this, &sender, args = e]() mutable { (*this)(sender, args); });
+            }
+            /// @brief Invoke the methods represented by the current event concurrently on the
+            /// threads of a ThreadPool, and wait for all of them to return.
+            ///
+            /// The methods are started in the order they were added. If a method calls
+            /// <code>e.halt(true)</code>, methods that have not yet started are not called;
+            /// methods that are already running on other threads are not interrupted.
+            /// All of the methods receive the same sender and e objects, so any changes
+            /// that they make to them must be thread safe.
+            /// @param pool The ThreadPool to run the methods on.
             /// @param sender The object that called invoke.
             /// @param e an event args object. It must be derived from EventArgs.
-            virtual void operator ()(sender_t& sender, eventArgs_t& e)
+            void invokeParallel(interthread::ThreadPool& pool, sender_t& sender, eventArgs_t& e)
             {
-                if (EventHandler<sender_t, eventArgs_t>::functions().empty())
+                auto functions = EventHandler<sender_t, eventArgs_t>::functions();
+                auto invocations = EventHandler<sender_t, eventArgs_t>::invocationsOf(functions);
+                std::atomic<bool> dead = false;
+                pool.parallelFor(invocations.size(), [&invocations, &dead, &sender, &e](size_t index) {
+                    auto lock = invocations[index].lock();
+                    if (!lock)
+                    {
+                        dead.store(true, std::memory_order_relaxed);
+                    }
+                    else if (!e.halt())
+                    {
+                        invocations[index].call(sender, e);
+                    }
+                });
+                if (dead)
                 {
-                    return;
+                    EventHandler<sender_t, eventArgs_t>::prune();
                 }
-                std::vector<EventHandler<sender_t, eventArgs_t>::function_t> functions;
-                auto& event = const_cast<Event&>(*this);
+                EventHandler<sender_t, eventArgs_t>::resumeWaiters(sender, e);
+            }
+            /// @brief Invoke the methods represented by the current event once for each
+            /// sender and event args pair in a batch.
+            ///
+            /// The function list is retrieved once for the whole batch. In either order,
+            /// once a method calls <code>e.halt(true)</code>, no more methods are called
+            /// for that event args object; the other events in the batch are not affected.
+            /// Events whose args are already halted are not delivered at all.
+            /// @param batch The sender and event args for each invocation.
+            /// @param order The order in which to call the methods.
+            void invokeBatch(std::span<std::tuple<sender_t&, eventArgs_t&>> batch,
+                BatchOrder order = BatchOrder::EventMajor)
+            {
+                auto functions = EventHandler<sender_t, eventArgs_t>::functions();
+                auto invocations = EventHandler<sender_t, eventArgs_t>::invocationsOf(functions);
+                bool dead = false;
+                if (order == BatchOrder::EventMajor)
+                {
+                    for (auto& [sender, e] : batch)
+                    {
+                        for (const auto& invocation : invocations)
+                        {
+                            if (e.halt())
+                            {
+                                break;
+                            }
+                            if (auto lock = invocation.lock())
+                            {
+                                invocation.call(sender, e);
+                            }
+                            else
+                            {
+                                dead = true;
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    for (const auto& invocation : invocations)
+                    {
+                        for (auto& [sender, e] : batch)
+                        {
+                            if (e.halt())
+                            {
+                                continue;
+                            }
+                            if (auto lock = invocation.lock())
+                            {
+                                invocation.call(sender, e);
+                            }
+                            else
+                            {
+                                dead = true;
+                            }
+                        }
+                    }
+                }
+                if (dead)
                 {
-                    std::lock_guard<std::mutex> lock(event.functionsLock());
-                    functions = event.functions();
+                    EventHandler<sender_t, eventArgs_t>::prune();
                 }
-                for (size_t index = 0; index < functions.size(); ++index)
+                // A coroutine that is resumed inline and waits again receives the next event.
+                for (auto& [sender, e] : batch)
                 {
-                    functions[index](sender, e);
-                    if(e.halt()) return;
+                    EventHandler<sender_t, eventArgs_t>::resumeWaiters(sender, e);
                 }
             }
+            /// @brief Invoke the methods represented by the current event.
+            /// @param sender The object that called invoke.
+            /// @param e an event args object. It must be derived from EventArgs.
+            virtual void operator ()(sender_t& sender, eventArgs_t& e)
+            {
+                auto functions = EventHandler<sender_t, eventArgs_t>::functions();
+                bool dead = false;
+                for (const auto& invocation : EventHandler<sender_t, eventArgs_t>::invocationsOf(functions))
+                {
+                    auto lock = invocation.lock();
+                    if (!lock)
+                    {
+                        dead = true;
+                        continue;
+                    }
+                    invocation.call(sender, e);
+                    if(e.halt()) break;
+                }
+                if (dead)
+                {
+                    EventHandler<sender_t, eventArgs_t>::prune();
+                }
+                EventHandler<sender_t, eventArgs_t>::resumeWaiters(sender, e);
+            }
+        private:
+            static auto handOff(const affine& function)
+                -> typename EventHandler<sender_t, eventArgs_t>::function_t
+            {
+                static_assert(sizeof(eventArgs_t) <= maxPostedArgsSize,
+                    "The event args are larger than Event::maxPostedArgsSize.");
+                using function_t = typename EventHandler<sender_t, eventArgs_t>::function_t;
+                // A function_t is too large to be stored inline in another function_t, so the
+                // method is shared by the handler and the tasks that it posts.
+                return [function = std::make_shared<const function_t>(function.function),
+                    executor = &function.executor](sender_t& sender, eventArgs_t& e) {
+                        executor->post([function, &sender, args = e]() mutable {
+                            (*function)(sender, args);
+                        });
+                };
+            }
     };
+
+    static_assert(sizeof(Event<Object, EventArgs>) == 2 * sizeof(void*),
+        "An Event must contain only its vtable pointer and a pointer to its storage.");
 }
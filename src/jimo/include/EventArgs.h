@@ -3,6 +3,7 @@
 /// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
 
 #pragma once
+#include <atomic>
 #include <concepts>
 #include <string>
 
@@ -30,20 +31,28 @@ namespace jimo
             EventArgs() = default;
             /// @brief Copy constructor
             /// @param other the EventArgs object to copy
-            EventArgs(const EventArgs& other) = default;
+            EventArgs(const EventArgs& other) noexcept : m_halt(other.halt()) {}
             /// @brief Move constructor
             /// @param other the EventArgs object to move
-            EventArgs(EventArgs&& other) = default;
+            EventArgs(EventArgs&& other) noexcept : m_halt(other.halt()) {}
             /// @brief Destructor
             virtual ~EventArgs() noexcept {}
             /// @brief Copy equals operator
             /// @param other the EventArgs object to copy
             /// @return the copied EventArgs object
-            inline EventArgs& operator =(const EventArgs& other) = default;
+            inline EventArgs& operator =(const EventArgs& other) noexcept
+            {
+                halt(other.halt());
+                return *this;
+            }
             /// @brief Move equals operator
             /// @param other the EventArgs object to move
             /// @return the moved EventArgs object
-            inline EventArgs& operator =(EventArgs&& other) = default;
+            inline EventArgs& operator =(EventArgs&& other) noexcept
+            {
+                halt(other.halt());
+                return *this;
+            }
 
             /// @brief Determine if the contents of the eventArgs objects are the same.
             /// @param other The EventArgs object to compare for equality.
@@ -76,12 +85,14 @@ namespace jimo
             /// to determine if additional functions should be called. See the
             /// [Events discussion](https://github.com/jimorc/jimo/blob/main/docs_doxygen/events.md)
             /// for more information.
-            bool halt() const noexcept { return m_halt; }
+            bool halt() const noexcept { return m_halt.load(std::memory_order_relaxed); }
             /// @brief Set the halt value.
             /// @param halt true to stop calling the event handlers that were added after
             /// this one, false to continue calling the added event handlers.
-            void halt(bool halt) noexcept { m_halt = halt; }
+            /// @remarks The halt value may be set from an event handler that is running
+            /// on another thread; see Event::invokeParallel.
+            void halt(bool halt) noexcept { m_halt.store(halt, std::memory_order_relaxed); }
         private:
-            bool m_halt{ false };
+            std::atomic<bool> m_halt{ false };
     };
 }
\ No newline at end of file
@@ -0,0 +1,278 @@
+/// @file EventArgsPool.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "EventArgs.h"
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace jimo
+{
+    /// @brief Recycles the memory of heap allocated EventArgs objects.
+    ///
+    /// Events whose args must outlive the publishing call, for example because they are
+    /// passed to another thread, usually allocate a new args object for every publication.
+    /// EventArgsPool::make constructs the args in memory taken from a pool, and the memory is
+    /// returned to the pool, rather than freed, when the pointer is destroyed. Once the pool
+    /// holds enough memory, publishing allocates nothing.
+    ///
+    /// Each thread has its own pool for each args type, so making args never locks or
+    /// contends with other threads. Memory always returns to the pool of the thread that
+    /// made the args, even when another thread destroys them: a thread that makes args
+    /// and hands them to a consumer thread gets the memory back for its next make. Memory
+    /// returned by other threads is pushed onto a lock-free list that the owning thread
+    /// takes in one operation. Each pool keeps at most maxPooled() blocks; more are freed.
+    /// A thread's pool is freed when the thread exits and the last of its args has been
+    /// destroyed.
+    ///
+    /// Only the memory is reused: every args object is newly constructed by make and
+    /// destroyed when its pointer is destroyed.
+    /// @tparam eventArgs_t The type of the event args. It must be derived from EventArgs.
+    template<typename eventArgs_t>
+    requires std::derived_from<eventArgs_t, EventArgs>
+    class EventArgsPool
+    {
+        private:
+            struct pool_state;
+            // The memory for one args object, and the pool that it belongs to.
+            struct block
+            {
+                pool_state* owner;
+                block* next;
+                alignas(eventArgs_t) std::byte args[sizeof(eventArgs_t)];
+            };
+        public:
+            /// @brief Destroys an args object and returns its memory to the pool of the
+            /// thread that made it.
+            struct releaser
+            {
+                /// @brief Destroy the args object and pool its memory.
+                /// @param e The args object.
+                void operator ()(eventArgs_t* e) const noexcept
+                {
+                    e->~eventArgs_t();
+                    auto released = blockOf(e);
+                    released->owner->release(released);
+                }
+            };
+            /// @brief The type of the pointers returned by make.
+            using pointer = std::unique_ptr<eventArgs_t, releaser>;
+            /// @brief The default maximum number of blocks in each thread's pool.
+            static constexpr std::size_t defaultMaxPooled = 64;
+
+            /// @brief Construct an args object in pooled memory.
+            /// @tparam arguments_t The types of the constructor arguments.
+            /// @param ...arguments The arguments to pass to the eventArgs_t constructor.
+            /// @return A pointer to the new args object.
+            template<typename... arguments_t>
+            requires std::constructible_from<eventArgs_t, arguments_t...>
+            static pointer make(arguments_t&&... arguments)
+            {
+                auto& blocks = pool();
+                auto taken = blocks.pop();
+                if (!taken)
+                {
+                    taken = allocate(blocks);
+                }
+                try
+                {
+                    auto e = ::new (taken->args)
+                        eventArgs_t(std::forward<arguments_t>(arguments)...);
+                    blocks.references.fetch_add(1, std::memory_order_relaxed);
+                    return pointer(e);
+                }
+                catch (...)
+                {
+                    blocks.push(taken);
+                    throw;
+                }
+            }
+            /// @brief Allocate memory for args objects in the current thread's pool, so that
+            /// the first publications do not allocate.
+            /// @param count The number of blocks that the pool is to hold. It is limited to
+            /// maxPooled().
+            static void reserve(std::size_t count)
+            {
+                auto& blocks = pool();
+                blocks.collect();
+                while (blocks.size < count && blocks.size < blocks.maxSize)
+                {
+                    blocks.push(allocate(blocks));
+                }
+            }
+            /// @brief Free all of the memory in the current thread's pool.
+            static void trim()
+            {
+                auto& blocks = pool();
+                blocks.collect();
+                blocks.clear();
+            }
+            /// @brief Retrieve the number of blocks in the current thread's pool.
+            /// @return The number of blocks that make can use without allocating.
+            static std::size_t pooled()
+            {
+                auto& blocks = pool();
+                blocks.collect();
+                return blocks.size;
+            }
+            /// @brief Retrieve the maximum number of blocks in the current thread's pool.
+            /// @return The maximum number of blocks.
+            static std::size_t maxPooled() { return pool().maxSize; }
+            /// @brief Set the maximum number of blocks in the current thread's pool.
+            ///
+            /// Blocks in excess of the new maximum are freed.
+            /// @param count The maximum number of blocks.
+            static void maxPooled(std::size_t count)
+            {
+                auto& blocks = pool();
+                blocks.collect();
+                blocks.maxSize = count;
+                while (blocks.size > count)
+                {
+                    free(blocks.pop());
+                }
+            }
+        private:
+            // A thread's pool. Only the owning thread uses head, size, and maxSize. Other
+            // threads push blocks onto returned. The pool is deleted by whichever of the
+            // owning thread and the releasers of its blocks drops the last reference.
+            struct pool_state
+            {
+                void push(block* pushed) noexcept
+                {
+                    if (size == maxSize)
+                    {
+                        free(pushed);
+                        return;
+                    }
+                    pushed->next = head;
+                    head = pushed;
+                    ++size;
+                }
+                block* pop() noexcept
+                {
+                    if (!head)
+                    {
+                        collect();
+                        if (!head)
+                        {
+                            return nullptr;
+                        }
+                    }
+                    auto popped = head;
+                    head = popped->next;
+                    --size;
+                    return popped;
+                }
+                // Move the blocks that other threads have returned into the pool.
+                void collect() noexcept
+                {
+                    if (!returned.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                    // Only this thread takes from returned, and it takes the whole list, so
+                    // the list cannot change under it.
+                    auto taken = returned.exchange(nullptr, std::memory_order_acquire);
+                    while (taken)
+                    {
+                        auto following = taken->next;
+                        push(taken);
+                        taken = following;
+                    }
+                }
+                void clear() noexcept
+                {
+                    while (head)
+                    {
+                        auto following = head->next;
+                        free(head);
+                        head = following;
+                    }
+                    size = 0;
+                }
+                void release(block* released) noexcept
+                {
+                    if (this == current())
+                    {
+                        push(released);
+                        references.fetch_sub(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    released->next = returned.load(std::memory_order_relaxed);
+                    while (!returned.compare_exchange_weak(released->next, released,
+                        std::memory_order_release, std::memory_order_relaxed)) {}
+                    unreference();
+                }
+                void unreference() noexcept
+                {
+                    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        // The owning thread has exited, and no args are left.
+                        auto taken = returned.exchange(nullptr, std::memory_order_acquire);
+                        while (taken)
+                        {
+                            auto following = taken->next;
+                            free(taken);
+                            taken = following;
+                        }
+                        delete this;
+                    }
+                }
+
+                block* head = nullptr;
+                std::size_t size = 0;
+                std::size_t maxSize = defaultMaxPooled;
+                std::atomic<block*> returned { nullptr };
+                // One for the owning thread, plus one for each args object that is alive.
+                std::atomic<std::size_t> references { 1 };
+            };
+            // Frees the owning thread's pool when the thread exits.
+            struct pool_owner
+            {
+                pool_owner() : state(new pool_state) { current() = state; }
+                ~pool_owner()
+                {
+                    current() = nullptr;
+                    state->collect();
+                    state->clear();
+                    state->unreference();
+                }
+
+                pool_state* state;
+            };
+
+            static pool_state& pool()
+            {
+                thread_local pool_owner owner;
+                return *owner.state;
+            }
+            // The current thread's pool, or nullptr if the thread has no pool. Unlike pool,
+            // this does not create a pool, so releasing args on a consumer thread does not.
+            static pool_state*& current() noexcept
+            {
+                thread_local pool_state* state = nullptr;
+                return state;
+            }
+            static block* blockOf(eventArgs_t* e) noexcept
+            {
+                return reinterpret_cast<block*>(
+                    reinterpret_cast<std::byte*>(e) - offsetof(block, args));
+            }
+            static block* allocate(pool_state& owner)
+            {
+                auto allocated = std::allocator<block>().allocate(1);
+                allocated->owner = &owner;
+                return allocated;
+            }
+            static void free(block* freed) noexcept
+            {
+                std::allocator<block>().deallocate(freed, 1);
+            }
+    };
+}
@@ -0,0 +1,146 @@
+/// @file EventBus.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Connection.h"
+#include "Event.h"
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace jimo
+{
+    /// @brief A set of Events that are selected by key.
+    ///
+    /// Each key, or topic, has its own Event. Subscribers subscribe to the topics that they
+    /// are interested in, and publishing to a topic finds its Event with one hash lookup and
+    /// invokes only that Event's methods. This replaces a single Event whose methods each
+    /// check a key in the event args, and so must all be called for every publication.
+    ///
+    /// Keys are typically integers, enumerations, or strings. To avoid hashing a string for
+    /// every publication, intern the topic names as integers.
+    ///
+    /// EventBus is thread safe. Publishing takes a shared lock only while the topic is looked
+    /// up, so publications to different topics, or to the same topic, run concurrently.
+    /// Topics are created by subscribe, and are not removed when their last method is
+    /// removed, so references to topics remain valid until the EventBus is destroyed.
+    /// @tparam key_t The type of the keys.
+    /// @tparam sender_t The type of the object that publishes the events.
+    /// @tparam eventArgs_t The type of the event arguments. It must be EventArgs or derived
+    /// from EventArgs.
+    /// @tparam hash_t The hash function for the keys.
+    template<typename key_t, typename sender_t, typename eventArgs_t,
+        typename hash_t = std::hash<key_t>>
+    requires std::derived_from<eventArgs_t, EventArgs>
+    class EventBus
+    {
+        public:
+            /// @brief The type of the Event for each topic.
+            using event_t = Event<sender_t, eventArgs_t>;
+            /// @brief The type of the methods that handle the events.
+            using function_t = typename event_t::function_t;
+            /// @brief Constructor
+            EventBus() = default;
+            /// @brief Copy constructor
+            EventBus(const EventBus&) = delete;
+            /// @brief Move constructor
+            EventBus(EventBus&&) = delete;
+            /// @brief Destructor
+            virtual ~EventBus() noexcept = default;
+            /// @brief Copy equals operator
+            EventBus& operator =(const EventBus&) = delete;
+            /// @brief Move equals operator
+            EventBus& operator =(EventBus&&) = delete;
+            /// @brief Add a method to a topic.
+            /// @param key The topic. It is created if it does not exist.
+            /// @param function The method to call when an event is published to the topic.
+            /// @return A Connection that removes the method from the topic.
+            Connection subscribe(const key_t& key, const function_t& function)
+            {
+                return topic(key).subscribe(function);
+            }
+            /// @brief Remove a method from a topic.
+            /// @param key The topic.
+            /// @param function The method to remove.
+            void unsubscribe(const key_t& key, const function_t& function)
+            {
+                if (auto event = find(key))
+                {
+                    *event -= function;
+                }
+            }
+            /// @brief Invoke the methods that are subscribed to a topic.
+            ///
+            /// The methods of other topics are not called. Publishing to a topic that has no
+            /// methods does nothing.
+            /// @param key The topic.
+            /// @param sender The object that is publishing the event.
+            /// @param e an event args object.
+            void publish(const key_t& key, sender_t& sender, eventArgs_t& e)
+            {
+                if (auto event = find(key))
+                {
+                    (*event)(sender, e);
+                }
+            }
+            /// @brief Retrieve the Event for a topic, creating it if it does not exist.
+            ///
+            /// Use the Event to subscribe to the topic with priorities or tracked targets, or
+            /// to wait for the topic in a coroutine.
+            /// @param key The topic.
+            /// @return The topic's Event.
+            event_t& topic(const key_t& key)
+            {
+                {
+                    std::shared_lock<std::shared_mutex> lock(m_lock);
+                    auto found = m_topics.find(key);
+                    if (found != m_topics.end())
+                    {
+                        return found->second;
+                    }
+                }
+                std::lock_guard<std::shared_mutex> lock(m_lock);
+                return m_topics[key];
+            }
+            /// @brief Retrieve the number of methods that are subscribed to a topic.
+            /// @param key The topic.
+            /// @return The number of methods.
+            std::size_t size(const key_t& key) const
+            {
+                auto event = find(key);
+                return event ? event->size() : 0;
+            }
+            /// @brief Retrieve the number of topics.
+            /// @return The number of topics that have been subscribed to.
+            std::size_t topics() const
+            {
+                std::shared_lock<std::shared_mutex> lock(m_lock);
+                return m_topics.size();
+            }
+            /// @brief Remove all of the methods from all of the topics.
+            void clear()
+            {
+                std::shared_lock<std::shared_mutex> lock(m_lock);
+                for (auto& [key, event] : m_topics)
+                {
+                    event.clear();
+                }
+            }
+        private:
+            event_t* find(const key_t& key) const
+            {
+                std::shared_lock<std::shared_mutex> lock(m_lock);
+                auto found = m_topics.find(key);
+                // The elements of an unordered_map are never moved, so the Event remains
+                // valid after the lock is released.
+                return found == m_topics.end() ? nullptr : const_cast<event_t*>(&found->second);
+            }
+
+            mutable std::shared_mutex m_lock;
+            std::unordered_map<key_t, event_t, hash_t> m_topics;
+    };
+}
@@ -0,0 +1,174 @@
+/// @file EventDispatcher.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Connection.h"
+#include "Event.h"
+#include "Object.h"
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace jimo
+{
+    /// @brief A central dispatcher that routes events by the type of their event args.
+    ///
+    /// Subscribers subscribe to an EventArgs type, rather than to an Event member of each
+    /// publishing object, and receive every event of that type published through the
+    /// dispatcher by any sender:
+    /// <code>dispatcher.subscribe<SavedEventArgs>(handler);</code> and
+    /// <code>dispatcher.publish(document, savedArgs);</code>
+    ///
+    /// Each EventArgs type is given a small integer index the first time that it is used
+    /// with an EventDispatcher, without using RTTI, and the dispatcher keeps an Event for
+    /// each type in a table indexed by it, so publishing finds the handlers in constant time.
+    /// The indexes are assigned at run time, in the order that the types are first used, so
+    /// they are not constant expressions and can differ between runs. Unique compile-time
+    /// ids, such as the address of a variable for each type, are too sparse to index a
+    /// table. Events are routed by their exact static type: publishing a DerivedEventArgs
+    /// does not call handlers that subscribed to EventArgs.
+    ///
+    /// EventDispatcher is thread safe. The table is replaced, rather than changed, when a
+    /// new type is subscribed to, so publishing never waits for a subscription. It can be
+    /// used alongside Event members; for example, a publisher may fire its own Event and
+    /// then publish the same args through a dispatcher.
+    /// @tparam sender_t The type that the handlers receive as the sender. It is Object by
+    /// default, so that any publisher derived from Object can publish.
+    template<typename sender_t = Object>
+    class EventDispatcher
+    {
+        public:
+            /// @brief The type of the Event for an EventArgs type.
+            template<typename eventArgs_t>
+            using event_t = Event<sender_t, eventArgs_t>;
+            /// @brief Constructor
+            EventDispatcher() = default;
+            /// @brief Copy constructor
+            EventDispatcher(const EventDispatcher&) = delete;
+            /// @brief Move constructor
+            EventDispatcher(EventDispatcher&&) = delete;
+            /// @brief Destructor
+            virtual ~EventDispatcher() noexcept = default;
+            /// @brief Copy equals operator
+            EventDispatcher& operator =(const EventDispatcher&) = delete;
+            /// @brief Move equals operator
+            EventDispatcher& operator =(EventDispatcher&&) = delete;
+            /// @brief Add a handler for an EventArgs type.
+            /// @tparam eventArgs_t The EventArgs type. It must be given explicitly.
+            /// @param function The handler.
+            /// @return A Connection that removes the handler.
+            template<typename eventArgs_t>
+            requires std::derived_from<eventArgs_t, EventArgs>
+            Connection subscribe(const typename event_t<eventArgs_t>::function_t& function)
+            {
+                return event<eventArgs_t>().subscribe(function);
+            }
+            /// @brief Remove a handler for an EventArgs type.
+            /// @tparam eventArgs_t The EventArgs type. It must be given explicitly.
+            /// @param function The handler to remove.
+            template<typename eventArgs_t>
+            requires std::derived_from<eventArgs_t, EventArgs>
+            void unsubscribe(const typename event_t<eventArgs_t>::function_t& function)
+            {
+                if (auto found = find<eventArgs_t>())
+                {
+                    *found -= function;
+                }
+            }
+            /// @brief Invoke the handlers for an EventArgs type.
+            ///
+            /// Publishing a type that has no handlers does nothing.
+            /// @tparam eventArgs_t The EventArgs type. It is deduced from e.
+            /// @param sender The object that is publishing the event.
+            /// @param e an event args object.
+            template<typename eventArgs_t>
+            requires std::derived_from<eventArgs_t, EventArgs>
+            void publish(sender_t& sender, eventArgs_t& e)
+            {
+                if (auto found = find<eventArgs_t>())
+                {
+                    (*found)(sender, e);
+                }
+            }
+            /// @brief Retrieve the Event for an EventArgs type, creating it if it does not exist.
+            ///
+            /// Use the Event to subscribe with priorities or tracked targets, or to wait for
+            /// the type in a coroutine. The Event remains valid until the EventDispatcher is
+            /// destroyed.
+            /// @tparam eventArgs_t The EventArgs type.
+            /// @return The Event.
+            template<typename eventArgs_t>
+            requires std::derived_from<eventArgs_t, EventArgs>
+            event_t<eventArgs_t>& event()
+            {
+                if (auto found = find<eventArgs_t>())
+                {
+                    return *found;
+                }
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto current = m_events.load(std::memory_order_acquire);
+                auto index = typeIndex<eventArgs_t>();
+                if (current && index < current->size() && (*current)[index])
+                {
+                    return *static_cast<event_t<eventArgs_t>*>((*current)[index].get());
+                }
+                auto updated = current ? std::make_shared<table>(*current) : std::make_shared<table>();
+                if (updated->size() <= index)
+                {
+                    updated->resize(index + 1);
+                }
+                auto created = std::make_shared<event_t<eventArgs_t>>();
+                auto& result = *created;
+                (*updated)[index] = std::move(created);
+                m_events.store(std::move(updated), std::memory_order_release);
+                return result;
+            }
+            /// @brief Retrieve the number of handlers for an EventArgs type.
+            /// @tparam eventArgs_t The EventArgs type.
+            /// @return The number of handlers.
+            template<typename eventArgs_t>
+            requires std::derived_from<eventArgs_t, EventArgs>
+            std::size_t size() const
+            {
+                auto found = find<eventArgs_t>();
+                return found ? found->size() : 0;
+            }
+        private:
+            // Each entry holds the Event for the type with that index, or nullptr.
+            using table = std::vector<std::shared_ptr<void>>;
+
+            static std::size_t nextIndex() noexcept
+            {
+                static std::atomic<std::size_t> next { 0 };
+                return next.fetch_add(1, std::memory_order_relaxed);
+            }
+            template<typename eventArgs_t>
+            static std::size_t typeIndex() noexcept
+            {
+                // Initialized once for each type, the first time that the type is used, so
+                // the index depends on the order in which the types are first used.
+                static const std::size_t index = nextIndex();
+                return index;
+            }
+            template<typename eventArgs_t>
+            event_t<eventArgs_t>* find() const
+            {
+                auto index = typeIndex<eventArgs_t>();
+                auto current = m_events.load(std::memory_order_acquire);
+                if (!current || index >= current->size())
+                {
+                    return nullptr;
+                }
+                // Only an event_t<eventArgs_t> is ever stored at this index. The Event is
+                // never removed, so it remains valid after current is released.
+                return static_cast<event_t<eventArgs_t>*>((*current)[index].get());
+            }
+
+            std::mutex m_lock;
+            std::atomic<std::shared_ptr<const table>> m_events;
+    };
+}
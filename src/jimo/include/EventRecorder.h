@@ -0,0 +1,504 @@
+/// @file EventRecorder.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Connection.h"
+#include "Event.h"
+#include "InplaceFunction.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// @brief The namespace for classes that record Events and replay them.
+namespace jimo::recording
+{
+    /// @brief The requirements for a class that converts event args to and from bytes.
+    ///
+    /// size returns the number of bytes that write will write for an event args object,
+    /// write writes them to a span of exactly that size, and read constructs an event args
+    /// object from them.
+    /// @tparam serializer_t The serializer type.
+    /// @tparam eventArgs_t The event args type.
+    template<typename serializer_t, typename eventArgs_t>
+    concept Serializer = requires(serializer_t serializer, const eventArgs_t& e,
+        std::span<std::byte> out, std::span<const std::byte> in)
+    {
+        { serializer.size(e) } -> std::convertible_to<std::size_t>;
+        serializer.write(e, out);
+        { serializer.read(in) } -> std::convertible_to<eventArgs_t>;
+    };
+
+    /// @brief The size, in bytes, of the largest serializer that EventRecorder::record and
+    /// EventReplayer::add accept.
+    ///
+    /// Serializers are stored in place, together with two pointers, in the handlers that
+    /// record and replay the events. A serializer that needs more state should hold it
+    /// through a pointer.
+    inline constexpr std::size_t maxSerializerSize = inplaceFunctionCapacity - 2 * sizeof(void*);
+
+    /// @brief A Serializer for event args that contain no data, such as EventArgs.
+    /// @tparam eventArgs_t The event args type. It must be default constructible.
+    template<typename eventArgs_t>
+    requires std::default_initializable<eventArgs_t>
+    struct EmptySerializer
+    {
+        /// @brief Retrieve the size of the serialized args.
+        /// @return 0
+        std::size_t size(const eventArgs_t&) const noexcept { return 0; }
+        /// @brief Write nothing.
+        void write(const eventArgs_t&, std::span<std::byte>) const noexcept {}
+        /// @brief Construct an event args object.
+        /// @return A default constructed event args object.
+        eventArgs_t read(std::span<const std::byte>) const { return eventArgs_t(); }
+    };
+
+    /// @brief The layout of an event log.
+    ///
+    /// A log starts with a header, followed by the records. Each record is a record_header
+    /// followed by the serialized event args, padded to a multiple of recordAlignment bytes.
+    /// All values are in the byte order of the recording machine.
+    ///
+    /// Event id 0 is reserved. Space that a recorder reserved but did not write, because its
+    /// process ended in between, is left zero filled, and reads as id 0; readers skip it.
+    struct EventLog
+    {
+        /// @brief The header at the start of a log.
+        struct header
+        {
+            /// @brief Identifies the region as an event log.
+            char magic[8];
+            /// @brief The number of bytes of records that follow the header.
+            std::uint64_t used;
+        };
+        /// @brief The header of each record.
+        struct record_header
+        {
+            /// @brief The number of bytes of serialized event args.
+            std::uint32_t size;
+            /// @brief The id that the Event was recorded with. It is never 0.
+            std::uint32_t eventId;
+            /// @brief The time of the dispatch, as a count of the recording clock's ticks
+            /// since its epoch.
+            std::int64_t time;
+        };
+        /// @brief The value of header::magic.
+        static constexpr char magic[8] = { 'j', 'i', 'm', 'o', 'e', 'v', 't', '1' };
+        /// @brief The alignment of each record, relative to the start of the records.
+        static constexpr std::size_t recordAlignment = 8;
+        /// @brief Retrieve the number of bytes that a record occupies in the log.
+        /// @param size The number of bytes of serialized event args.
+        /// @return The size of the record, including its header and padding.
+        static constexpr std::size_t recordSize(std::size_t size) noexcept
+        {
+            return sizeof(record_header) + ((size + recordAlignment - 1) & ~(recordAlignment - 1));
+        }
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+    /// @brief A file that is mapped into memory, to hold an event log.
+    ///
+    /// This class is only available on POSIX systems. On other systems, record into any
+    /// suitably aligned memory, and write it to a file yourself.
+    class MappedFile
+    {
+        public:
+            /// @brief Create a file of a fixed size and map it for writing.
+            ///
+            /// Any existing file is replaced. Changes to the memory are written to the file
+            /// by the operating system, even if the program crashes.
+            /// @param path The path of the file.
+            /// @param size The size of the file in bytes.
+            /// @exception std::system_error if the file cannot be created or mapped.
+            MappedFile(const std::string& path, std::size_t size)
+            {
+                auto file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (file < 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "Cannot create " + path);
+                }
+                if (::ftruncate(file, static_cast<off_t>(size)) != 0)
+                {
+                    auto error = errno;
+                    ::close(file);
+                    throw std::system_error(error, std::generic_category(), "Cannot size " + path);
+                }
+                map(file, size, PROT_READ | PROT_WRITE, path);
+            }
+            /// @brief Map an existing file for reading.
+            /// @param path The path of the file.
+            /// @exception std::system_error if the file cannot be opened or mapped.
+            explicit MappedFile(const std::string& path)
+            {
+                auto file = ::open(path.c_str(), O_RDONLY);
+                if (file < 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+                }
+                struct stat status;
+                if (::fstat(file, &status) != 0)
+                {
+                    auto error = errno;
+                    ::close(file);
+                    throw std::system_error(error, std::generic_category(), "Cannot stat " + path);
+                }
+                map(file, static_cast<std::size_t>(status.st_size), PROT_READ, path);
+            }
+            /// @brief Copy constructor
+            MappedFile(const MappedFile&) = delete;
+            /// @brief Move constructor
+            /// @param other The MappedFile to move. It maps nothing after the move.
+            MappedFile(MappedFile&& other) noexcept
+                : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+            /// @brief Destructor. Unmaps the file.
+            ~MappedFile() { unmap(); }
+            /// @brief Copy equals operator
+            MappedFile& operator =(const MappedFile&) = delete;
+            /// @brief Move equals operator
+            /// @param other The MappedFile to move. It maps nothing after the move.
+            /// @return This MappedFile.
+            MappedFile& operator =(MappedFile&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    unmap();
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                }
+                return *this;
+            }
+            /// @brief Retrieve the mapped memory.
+            /// @return The memory. It must not be written to if the file was mapped for reading.
+            std::span<std::byte> data() const noexcept
+            {
+                return { static_cast<std::byte*>(m_data), m_size };
+            }
+        private:
+            void map(int file, std::size_t size, int protection, const std::string& path)
+            {
+                if (size != 0)
+                {
+                    auto data = ::mmap(nullptr, size, protection, MAP_SHARED, file, 0);
+                    if (data == MAP_FAILED)
+                    {
+                        auto error = errno;
+                        ::close(file);
+                        throw std::system_error(error, std::generic_category(), "Cannot map " + path);
+                    }
+                    m_data = data;
+                    m_size = size;
+                }
+                ::close(file);
+            }
+            void unmap() noexcept
+            {
+                if (m_data)
+                {
+                    ::munmap(m_data, m_size);
+                    m_data = nullptr;
+                }
+            }
+
+            void* m_data = nullptr;
+            std::size_t m_size = 0;
+    };
+#endif
+
+    /// @brief Records the dispatches of Events into an append-only event log.
+    ///
+    /// Each Event to be recorded is given an id. Recording an Event subscribes a handler to
+    /// it that appends a record containing the id, the time from clock_t, and the event args
+    /// serialized by a Serializer. Appending reserves space in the log with a single atomic
+    /// compare and exchange, so Events may be fired on any number of threads, and recording
+    /// costs little more than reading the clock and serializing the args.
+    ///
+    /// The log is stored in memory supplied by the caller, typically a MappedFile. When the
+    /// log is full, further dispatches are counted by dropped() but not recorded.
+    /// The recording handler is added with the highest priority, so it records each dispatch
+    /// before any other handler can halt it.
+    /// @tparam clock_t A std::chrono clock.
+    template<typename clock_t = std::chrono::steady_clock>
+    requires std::chrono::is_clock_v<clock_t>
+    class EventRecorder
+    {
+        public:
+            /// @brief Construct an EventRecorder that writes a new log.
+            /// @param log The memory to write the log into. Any existing contents are
+            /// overwritten. It must be aligned to 8 bytes, and must remain valid until the
+            /// EventRecorder is destroyed.
+            /// @exception std::invalid_argument if log is too small or not aligned.
+            explicit EventRecorder(std::span<std::byte> log) : m_log(log)
+            {
+                if (m_log.size() < sizeof(EventLog::header) ||
+                    reinterpret_cast<std::uintptr_t>(m_log.data()) % alignof(EventLog::header) != 0)
+                {
+                    throw std::invalid_argument("An event log must be aligned, and large enough "
+                        "for its header.");
+                }
+                auto header = ::new (m_log.data()) EventLog::header {};
+                std::memcpy(header->magic, EventLog::magic, sizeof(EventLog::magic));
+                m_used = &header->used;
+                m_capacity = m_log.size() - sizeof(EventLog::header);
+            }
+            /// @brief Copy constructor
+            EventRecorder(const EventRecorder&) = delete;
+            /// @brief Move constructor
+            EventRecorder(EventRecorder&&) = delete;
+            /// @brief Destructor. Stops recording.
+            ~EventRecorder() noexcept
+            {
+                for (auto& connection : m_connections)
+                {
+                    connection.disconnect();
+                }
+            }
+            /// @brief Copy equals operator
+            EventRecorder& operator =(const EventRecorder&) = delete;
+            /// @brief Move equals operator
+            EventRecorder& operator =(EventRecorder&&) = delete;
+            /// @brief Start recording an Event.
+            /// @tparam sender_t The type of the Event's sender.
+            /// @tparam eventArgs_t The type of the Event's event args.
+            /// @tparam serializer_t The type of the serializer.
+            /// @param event The Event to record. Recording stops when this EventRecorder is
+            /// destroyed, or the returned Connection is disconnected.
+            /// @param eventId The id to record the Event's dispatches with. It must not be 0.
+            /// @param serializer The serializer for the event args. It must be no larger than
+            /// maxSerializerSize bytes.
+            /// @return A Connection for the recording handler.
+            /// @exception std::invalid_argument if eventId is 0.
+            template<typename sender_t, typename eventArgs_t,
+                typename serializer_t = EmptySerializer<eventArgs_t>>
+            requires Serializer<serializer_t, eventArgs_t>
+            Connection record(Event<sender_t, eventArgs_t>& event, std::uint32_t eventId,
+                serializer_t serializer = serializer_t())
+            {
+                static_assert(sizeof(serializer_t) <= maxSerializerSize,
+                    "The serializer is larger than maxSerializerSize.");
+                checkEventId(eventId);
+                auto connection = event.subscribe({ [this, eventId, serializer](sender_t&, eventArgs_t& e) mutable {
+                    append(eventId, e, serializer);
+                }, std::numeric_limits<int>::max() });
+                m_connections.push_back(connection);
+                return connection;
+            }
+            /// @brief Append a record to the log without an Event.
+            /// @tparam eventArgs_t The type of the event args.
+            /// @tparam serializer_t The type of the serializer.
+            /// @param eventId The id to record. It must not be 0.
+            /// @param e The event args.
+            /// @param serializer The serializer for the event args.
+            /// @return true if the record was appended, false if the log is full.
+            /// @exception std::invalid_argument if eventId is 0.
+            template<typename eventArgs_t, typename serializer_t>
+            requires Serializer<serializer_t, eventArgs_t>
+            bool append(std::uint32_t eventId, const eventArgs_t& e, serializer_t& serializer)
+            {
+                checkEventId(eventId);
+                auto time = clock_t::now().time_since_epoch().count();
+                auto size = serializer.size(e);
+                auto total = EventLog::recordSize(size);
+                std::atomic_ref<std::uint64_t> used(*m_used);
+                auto offset = used.load(std::memory_order_relaxed);
+                do
+                {
+                    if (total > m_capacity - offset)
+                    {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+                while (!used.compare_exchange_weak(offset, offset + total, std::memory_order_relaxed));
+                auto record = m_log.data() + sizeof(EventLog::header) + offset;
+                EventLog::record_header header { static_cast<std::uint32_t>(size), eventId,
+                    static_cast<std::int64_t>(time) };
+                std::memcpy(record, &header, sizeof(header));
+                serializer.write(e, std::span<std::byte>(record + sizeof(header), size));
+                return true;
+            }
+            /// @brief Retrieve the number of bytes of records in the log.
+            /// @return The number of bytes used.
+            std::size_t used() const noexcept
+            {
+                return static_cast<std::size_t>(
+                    std::atomic_ref<std::uint64_t>(*m_used).load(std::memory_order_relaxed));
+            }
+            /// @brief Retrieve the number of dispatches that were not recorded because the
+            /// log was full.
+            /// @return The number of dropped dispatches.
+            std::size_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+        private:
+            static void checkEventId(std::uint32_t eventId)
+            {
+                if (eventId == 0)
+                {
+                    throw std::invalid_argument("Event id 0 is reserved.");
+                }
+            }
+
+            std::span<std::byte> m_log;
+            std::uint64_t* m_used;
+            std::uint64_t m_capacity;
+            std::atomic<std::size_t> m_dropped { 0 };
+            std::vector<Connection> m_connections;
+    };
+
+    /// @brief How quickly EventReplayer::replay fires the recorded dispatches.
+    enum class ReplaySpeed
+    {
+        /// @brief Keep the recorded intervals between dispatches.
+        Recorded,
+        /// @brief Fire each dispatch as soon as the previous one returns.
+        Maximum,
+    };
+
+    /// @brief Replays an event log written by an EventRecorder.
+    ///
+    /// Add the Event to fire for each recorded id, then call replay. Replay a log only after
+    /// its EventRecorder has stopped recording. Each record is
+    /// deserialized and its Event is fired on the calling thread, in the order that the
+    /// records were appended. Records with ids that have not been added are skipped, as is
+    /// space that a recorder reserved but never wrote.
+    /// @tparam clock_t The clock that the log was recorded with.
+    template<typename clock_t = std::chrono::steady_clock>
+    requires std::chrono::is_clock_v<clock_t>
+    class EventReplayer
+    {
+        public:
+            /// @brief Construct an EventReplayer for a log.
+            /// @param log The log. It must remain valid until the EventReplayer is destroyed.
+            /// @exception std::invalid_argument if log does not contain an event log.
+            explicit EventReplayer(std::span<const std::byte> log) : m_log(log)
+            {
+                EventLog::header header;
+                if (m_log.size() < sizeof(header))
+                {
+                    throw std::invalid_argument("The event log is too small.");
+                }
+                std::memcpy(&header, m_log.data(), sizeof(header));
+                if (std::memcmp(header.magic, EventLog::magic, sizeof(EventLog::magic)) != 0 ||
+                    header.used > m_log.size() - sizeof(header))
+                {
+                    throw std::invalid_argument("The memory does not contain an event log.");
+                }
+                m_records = m_log.subspan(sizeof(header), static_cast<std::size_t>(header.used));
+            }
+            /// @brief Set the Event to fire for an id.
+            /// @tparam sender_t The type of the Event's sender.
+            /// @tparam eventArgs_t The type of the Event's event args.
+            /// @tparam serializer_t The type of the serializer.
+            /// @param eventId The id that the Event was recorded with.
+            /// @param event The Event to fire. It must remain valid until replay returns.
+            /// @param sender The sender to fire the Event with. It must remain valid until
+            /// replay returns.
+            /// @param serializer The serializer to read the event args with. It must be no larger
+            /// than maxSerializerSize bytes.
+            template<typename sender_t, typename eventArgs_t,
+                typename serializer_t = EmptySerializer<eventArgs_t>>
+            requires Serializer<serializer_t, eventArgs_t>
+            void add(std::uint32_t eventId, Event<sender_t, eventArgs_t>& event, sender_t& sender,
+                serializer_t serializer = serializer_t())
+            {
+                static_assert(sizeof(serializer_t) <= maxSerializerSize,
+                    "The serializer is larger than maxSerializerSize.");
+                m_targets.insert_or_assign(eventId,
+                    [&event, &sender, serializer](std::span<const std::byte> payload) mutable {
+                        eventArgs_t e = serializer.read(payload);
+                        event(sender, e);
+                    });
+            }
+            /// @brief Retrieve the number of records in the log.
+            /// @return The number of records.
+            std::size_t size() const noexcept
+            {
+                std::size_t count = 0;
+                forEach([&count](const EventLog::record_header&, std::span<const std::byte>) {
+                    ++count;
+                });
+                return count;
+            }
+            /// @brief Fire the Events for the records in the log.
+            /// @param speed Whether to keep the recorded intervals between dispatches.
+            /// @return The number of dispatches that were fired.
+            std::size_t replay(ReplaySpeed speed = ReplaySpeed::Recorded)
+            {
+                std::size_t fired = 0;
+                bool first = true;
+                typename clock_t::time_point start;
+                typename clock_t::duration firstTime {};
+                forEach([this, speed, &fired, &first, &start, &firstTime](
+                    const EventLog::record_header& header, std::span<const std::byte> payload) {
+                    auto target = m_targets.find(header.eventId);
+                    if (target == m_targets.end())
+                    {
+                        return;
+                    }
+                    typename clock_t::duration time(static_cast<typename clock_t::rep>(header.time));
+                    if (first)
+                    {
+                        start = clock_t::now();
+                        firstTime = time;
+                        first = false;
+                    }
+                    else if (speed == ReplaySpeed::Recorded)
+                    {
+                        std::this_thread::sleep_until(start + (time - firstTime));
+                    }
+                    target->second(payload);
+                    ++fired;
+                });
+                return fired;
+            }
+        private:
+            using target_t = InplaceFunction<void(std::span<const std::byte>), inplaceFunctionCapacity, false>;
+
+            template<typename function_t>
+            void forEach(function_t&& function) const
+            {
+                std::size_t offset = 0;
+                while (m_records.size() - offset >= sizeof(EventLog::record_header))
+                {
+                    EventLog::record_header header;
+                    std::memcpy(&header, m_records.data() + offset, sizeof(header));
+                    if (header.eventId == 0)
+                    {
+                        // Reserved space that was never written. The next record starts at
+                        // one of the following aligned offsets.
+                        offset += EventLog::recordAlignment;
+                        continue;
+                    }
+                    auto total = EventLog::recordSize(header.size);
+                    if (total > m_records.size() - offset)
+                    {
+                        return;
+                    }
+                    function(header, m_records.subspan(offset + sizeof(header), header.size));
+                    offset += total;
+                }
+            }
+
+            std::span<const std::byte> m_log;
+            std::span<const std::byte> m_records;
+            std::unordered_map<std::uint32_t, target_t> m_targets;
+    };
+}
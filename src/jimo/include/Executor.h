@@ -0,0 +1,32 @@
+/// @file Executor.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "InplaceFunction.h"
+#include <cstddef>
+
+/// @brief The namespace for classes that run work on, or pass data between, threads.
+namespace jimo::interthread
+{
+    /// @brief The number of bytes available to store a task that is posted to an Executor.
+    inline constexpr std::size_t executorTaskCapacity = 4 * inplaceFunctionCapacity;
+
+    /// @brief Abstract class that defines an interface for running tasks.
+    ///
+    /// Derived classes determine where and when the posted tasks run; for example, on the
+    /// threads of a ThreadPool.
+    class Executor
+    {
+        public:
+            /// @brief The type of the tasks that are posted to an Executor.
+            ///
+            /// Tasks are move-only and are stored without allocating memory.
+            using task_t = InplaceFunction<void(), executorTaskCapacity, false>;
+            /// @brief Destructor
+            virtual ~Executor() = default;
+            /// @brief Post a task to be run.
+            /// @param task The task to run.
+            virtual void post(task_t task) = 0;
+    };
+}
@@ -0,0 +1,355 @@
+/// @file InplaceFunction.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#ifndef JIMO_INPLACE_FUNCTION_CAPACITY
+/// @brief The default number of bytes available to store a callable in an InplaceFunction.
+///
+/// Define this macro before including any jimo header to change the storage available to
+/// the functions in every Delegate and Event.
+#define JIMO_INPLACE_FUNCTION_CAPACITY (6 * sizeof(void*))
+#endif
+
+namespace jimo
+{
+    /// @brief The default number of bytes available to store a callable in an InplaceFunction.
+    inline constexpr std::size_t inplaceFunctionCapacity = JIMO_INPLACE_FUNCTION_CAPACITY;
+
+    /// @brief Pass one argument to a function that is not the last of several functions
+    /// called with the same arguments.
+    ///
+    /// References, trivially copyable values, and move-only values are passed by rvalue
+    /// reference, so a large struct is not copied for a function that takes it by const
+    /// reference. Moving from a trivially copyable value does not change it, so the
+    /// following functions see the same value. A function that takes a move-only value
+    /// by value takes ownership of it, and the following functions see the moved-from
+    /// value. All other values are copied, so that each function receives its own copy.
+    /// @tparam argument_t The parameter type of the functions.
+    /// @param argument The argument.
+    /// @return An rvalue reference to argument, or a copy of argument.
+    template<typename argument_t>
+    decltype(auto) shareArgument(std::remove_reference_t<argument_t>& argument)
+    {
+        if constexpr (std::is_reference_v<argument_t> ||
+            std::is_trivially_copyable_v<argument_t> ||
+            !std::is_copy_constructible_v<argument_t>)
+        {
+            return static_cast<argument_t&&>(argument);
+        }
+        else
+        {
+            return argument_t(argument);
+        }
+    }
+
+    template<typename signature_t, std::size_t capacity = inplaceFunctionCapacity,
+        bool copyable = true>
+    class InplaceFunction;
+
+    /// @brief A fixed capacity replacement for std::function that never allocates memory.
+    ///
+    /// The callable (function pointer, Functor, lambda, or bind expression) is stored in a
+    /// buffer inside the InplaceFunction object. A callable that is too large for the buffer,
+    /// or that requires stricter alignment than std::max_align_t, fails to compile.
+    ///
+    /// InplaceFunction is the storage type for the functions in Delegate and EventHandler.
+    /// @tparam result_t The result type returned by the callable.
+    /// @tparam arguments_t The argument types of the callable.
+    /// @tparam capacity The number of bytes available to store the callable.
+    /// @tparam copyable true if the InplaceFunction can be copied. When false, the
+    /// InplaceFunction is move-only and may store move-only callables.
+    template<typename result_t, typename... arguments_t, std::size_t capacity, bool copyable>
+    class InplaceFunction<result_t(arguments_t...), capacity, copyable>
+    {
+        public:
+            /// @brief Construct an empty InplaceFunction.
+            InplaceFunction() noexcept = default;
+            /// @brief Construct an empty InplaceFunction.
+            InplaceFunction(std::nullptr_t) noexcept {}
+            /// @brief Construct an InplaceFunction that stores a copy of a callable.
+            /// @tparam callable_t The type of the callable.
+            /// @param callable The function pointer, Functor, or lambda to store.
+            template<typename callable_t>
+            requires (!std::same_as<std::remove_cvref_t<callable_t>, InplaceFunction>) &&
+                std::is_invocable_r_v<result_t, std::decay_t<callable_t>&, arguments_t...>
+            InplaceFunction(callable_t&& callable)
+            {
+                using stored_t = std::decay_t<callable_t>;
+                static_assert(sizeof(stored_t) <= capacity,
+                    "The callable is too large to be stored in this InplaceFunction.");
+                static_assert(alignof(stored_t) <= alignof(std::max_align_t),
+                    "The callable's alignment is too strict for an InplaceFunction.");
+                static_assert(std::is_nothrow_move_constructible_v<stored_t>,
+                    "The callable stored in an InplaceFunction must be nothrow move constructible.");
+                static_assert(!copyable || std::is_copy_constructible_v<stored_t>,
+                    "A copyable InplaceFunction cannot store a move-only callable.");
+                if constexpr (std::is_pointer_v<std::remove_cvref_t<callable_t>> ||
+                    std::is_member_pointer_v<std::remove_cvref_t<callable_t>>)
+                {
+                    if (callable == nullptr)
+                    {
+                        return;
+                    }
+                }
+                ::new (static_cast<void*>(m_storage)) stored_t(std::forward<callable_t>(callable));
+                m_operations = &operationsFor<stored_t>;
+            }
+            /// @brief Copy constructor
+            /// @param other The InplaceFunction to copy.
+            InplaceFunction(const InplaceFunction& other) requires copyable
+            {
+                if (other.m_operations)
+                {
+                    other.m_operations->copy(m_storage, other.m_storage);
+                    m_operations = other.m_operations;
+                }
+            }
+            /// @brief Move constructor
+            /// @param other The InplaceFunction to move. It is empty after the move.
+            InplaceFunction(InplaceFunction&& other) noexcept
+            {
+                if (other.m_operations)
+                {
+                    other.m_operations->move(m_storage, other.m_storage);
+                    m_operations = std::exchange(other.m_operations, nullptr);
+                }
+            }
+            /// @brief Destructor
+            ~InplaceFunction() { reset(); }
+            /// @brief Copy equals operator
+            /// @param other The InplaceFunction to copy.
+            /// @return This InplaceFunction.
+            InplaceFunction& operator =(const InplaceFunction& other) requires copyable
+            {
+                if (this != &other)
+                {
+                    InplaceFunction copy(other);
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+            /// @brief Move equals operator
+            /// @param other The InplaceFunction to move. It is empty after the move.
+            /// @return This InplaceFunction.
+            InplaceFunction& operator =(InplaceFunction&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    if (other.m_operations)
+                    {
+                        other.m_operations->move(m_storage, other.m_storage);
+                        m_operations = std::exchange(other.m_operations, nullptr);
+                    }
+                }
+                return *this;
+            }
+            /// @brief Make this InplaceFunction empty.
+            /// @return This InplaceFunction.
+            InplaceFunction& operator =(std::nullptr_t) noexcept
+            {
+                reset();
+                return *this;
+            }
+            /// @brief Call the stored callable.
+            /// @param ...args The arguments to pass to the callable.
+            /// @return The value returned by the callable.
+            /// @exception std::bad_function_call if the InplaceFunction is empty.
+            result_t operator ()(arguments_t... args) const
+            {
+                if (!m_operations)
+                {
+                    throw std::bad_function_call();
+                }
+                return m_operations->invoke(m_storage, std::forward<arguments_t>(args)...);
+            }
+            /// @brief Call the stored callable without copying its arguments.
+            ///
+            /// Unlike operator(), arguments of non-reference types are not copied into
+            /// parameters of this method. Each one is passed to the callable by rvalue
+            /// reference, so it is moved from only if the callable takes it by value.
+            /// @param ...args The arguments to pass to the callable.
+            /// @return The value returned by the callable.
+            /// @exception std::bad_function_call if the InplaceFunction is empty.
+            result_t call(arguments_t&&... args) const
+            {
+                if (!m_operations)
+                {
+                    throw std::bad_function_call();
+                }
+                return m_operations->invoke(m_storage, std::forward<arguments_t>(args)...);
+            }
+            /// @brief Check if this InplaceFunction stores a callable.
+            /// @return true if a callable is stored, false otherwise.
+            explicit operator bool() const noexcept { return m_operations != nullptr; }
+            /// @brief Retrieve the type of the stored callable.
+            /// @return typeid of the stored callable, or typeid(void) if empty.
+            const std::type_info& target_type() const noexcept
+            {
+                return m_operations ? m_operations->type() : typeid(void);
+            }
+            /// @brief Check if two InplaceFunctions store the same callable.
+            ///
+            /// Function pointers and other equality comparable callables, such as the
+            /// object and method pairs stored by Delegate, are compared by value. Callables
+            /// that cannot be compared, such as lambdas, are the same if they have the same type.
+            /// @param other The InplaceFunction to compare with this one.
+            /// @return true if both store callables of the same type that compare equal,
+            /// or if both are empty, false otherwise.
+            bool sameTarget(const InplaceFunction& other) const noexcept
+            {
+                return m_operations == other.m_operations &&
+                    (!m_operations || m_operations->equal(m_storage, other.m_storage));
+            }
+            /// @brief Retrieve a hash of the stored callable.
+            ///
+            /// InplaceFunctions for which sameTarget returns true have the same hash. Callables
+            /// for which std::hash is specialized, such as function pointers, are hashed by
+            /// value. Other callables, such as lambdas, cannot be hashed.
+            /// @return The hash, or 0 if the InplaceFunction is empty or its callable cannot
+            /// be hashed.
+            std::size_t targetHash() const noexcept
+            {
+                if (!m_operations || !m_operations->hash)
+                {
+                    return 0;
+                }
+                auto hash = std::hash<const void*>()(m_operations);
+                return hash ^ (m_operations->hash(m_storage) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+            }
+            /// @brief Retrieve a pointer to the stored callable.
+            /// @tparam target_t The type of the stored callable.
+            /// @return A pointer to the stored callable, or nullptr if the stored
+            /// callable is not of type target_t.
+            template<typename target_t>
+            target_t* target() noexcept
+            {
+                if (m_operations && m_operations->type() == typeid(target_t))
+                {
+                    return std::launder(reinterpret_cast<target_t*>(m_storage));
+                }
+                return nullptr;
+            }
+            /// @brief Retrieve a pointer to the stored callable.
+            /// @tparam target_t The type of the stored callable.
+            /// @return A pointer to the stored callable, or nullptr if the stored
+            /// callable is not of type target_t.
+            template<typename target_t>
+            const target_t* target() const noexcept
+            {
+                return const_cast<InplaceFunction&>(*this).template target<target_t>();
+            }
+        private:
+            struct operations
+            {
+                result_t (*invoke)(void* storage, arguments_t&&... args);
+                void (*copy)(void* destination, const void* source);
+                void (*move)(void* destination, void* source) noexcept;
+                void (*destroy)(void* storage) noexcept;
+                bool (*equal)(const void* left, const void* right) noexcept;
+                // nullptr if the callable cannot be hashed.
+                std::size_t (*hash)(const void* storage) noexcept;
+                const std::type_info& (*type)() noexcept;
+            };
+            template<typename stored_t>
+            static result_t invokeStored(void* storage, arguments_t&&... args)
+            {
+                auto& callable = *std::launder(static_cast<stored_t*>(storage));
+                if constexpr (std::is_void_v<result_t>)
+                {
+                    std::invoke(callable, std::forward<arguments_t>(args)...);
+                }
+                else
+                {
+                    return std::invoke(callable, std::forward<arguments_t>(args)...);
+                }
+            }
+            template<typename stored_t>
+            static void copyStored(void* destination, const void* source)
+            {
+                if constexpr (copyable)
+                {
+                    ::new (destination) stored_t(*std::launder(static_cast<const stored_t*>(source)));
+                }
+            }
+            template<typename stored_t>
+            static void moveStored(void* destination, void* source) noexcept
+            {
+                auto* callable = std::launder(static_cast<stored_t*>(source));
+                ::new (destination) stored_t(std::move(*callable));
+                callable->~stored_t();
+            }
+            template<typename stored_t>
+            static void destroyStored(void* storage) noexcept
+            {
+                std::launder(static_cast<stored_t*>(storage))->~stored_t();
+            }
+            template<typename stored_t>
+            static bool equalStored(const void* left, const void* right) noexcept
+            {
+                if constexpr (std::equality_comparable<stored_t>)
+                {
+                    return *std::launder(static_cast<const stored_t*>(left)) ==
+                        *std::launder(static_cast<const stored_t*>(right));
+                }
+                else
+                {
+                    return true;
+                }
+            }
+            template<typename stored_t>
+            static std::size_t hashStored(const void* storage) noexcept
+            {
+                return std::hash<stored_t>()(*std::launder(static_cast<const stored_t*>(storage)));
+            }
+            template<typename stored_t>
+            static constexpr auto hasherFor() noexcept -> std::size_t (*)(const void*) noexcept
+            {
+                if constexpr (requires(const stored_t& callable) {
+                    { std::hash<stored_t>()(callable) } -> std::convertible_to<std::size_t>; })
+                {
+                    return &hashStored<stored_t>;
+                }
+                else
+                {
+                    return nullptr;
+                }
+            }
+            template<typename stored_t>
+            static const std::type_info& storedType() noexcept
+            {
+                return typeid(stored_t);
+            }
+            template<typename stored_t>
+            static constexpr operations operationsFor
+            {
+                &invokeStored<stored_t>,
+                &copyStored<stored_t>,
+                &moveStored<stored_t>,
+                &destroyStored<stored_t>,
+                &equalStored<stored_t>,
+                hasherFor<stored_t>(),
+                &storedType<stored_t>
+            };
+            void reset() noexcept
+            {
+                if (m_operations)
+                {
+                    m_operations->destroy(m_storage);
+                    m_operations = nullptr;
+                }
+            }
+            const operations* m_operations = nullptr;
+            alignas(std::max_align_t) mutable std::byte m_storage[capacity];
+    };
+}
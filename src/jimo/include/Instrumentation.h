@@ -0,0 +1,120 @@
+/// @file Instrumentation.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <typeinfo>
+
+namespace jimo::timing
+{
+    /// @brief The number of buckets in a HandlerStatistics latency histogram.
+    inline constexpr std::size_t latencyBuckets = 32;
+
+    /// @brief The dispatch statistics for one function in a Delegate or Event.
+    ///
+    /// Delegate::statistics returns these when JIMO_DELEGATE_INSTRUMENTATION is defined.
+    struct HandlerStatistics
+    {
+        /// @brief The type of the function's callable. Use this to identify the function.
+        const std::type_info* type;
+        /// @brief The number of times the function has been called.
+        std::uint64_t invocations;
+        /// @brief The total time spent in the function.
+        std::chrono::nanoseconds totalTime;
+        /// @brief The latency histogram. Bucket i counts the calls that took from 2^i to
+        /// 2^(i+1) - 1 nanoseconds. Bucket 0 also counts calls that took less than 1 nanosecond,
+        /// and the last bucket also counts all longer calls.
+        std::array<std::uint64_t, latencyBuckets> histogram;
+    };
+
+    /// @brief Records the calls of one function in a Delegate or Event.
+    ///
+    /// The counters are updated with relaxed atomic operations, so functions that are called
+    /// concurrently, for example by Delegate::invokeParallel, are counted correctly.
+    /// This class is used by Delegate; you do not use it directly.
+    class HandlerCounters
+    {
+        public:
+            /// @brief The clock used to time calls. This is the default StopWatch clock.
+            using clock_t = std::chrono::steady_clock;
+            /// @brief Record a call.
+            /// @param duration The time taken by the call.
+            void record(clock_t::duration duration) noexcept
+            {
+                auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    duration).count();
+                m_invocations.fetch_add(1, std::memory_order_relaxed);
+                m_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+                m_histogram[bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+            }
+            /// @brief Retrieve the statistics.
+            /// @param type The type of the function's callable.
+            /// @return The statistics recorded so far.
+            HandlerStatistics statistics(const std::type_info& type) const noexcept
+            {
+                HandlerStatistics statistics { &type,
+                    m_invocations.load(std::memory_order_relaxed),
+                    std::chrono::nanoseconds(m_nanoseconds.load(std::memory_order_relaxed)),
+                    {} };
+                for (std::size_t index = 0; index < latencyBuckets; ++index)
+                {
+                    statistics.histogram[index] = m_histogram[index].load(std::memory_order_relaxed);
+                }
+                return statistics;
+            }
+            /// @brief Set all of the counters to zero.
+            void reset() noexcept
+            {
+                m_invocations.store(0, std::memory_order_relaxed);
+                m_nanoseconds.store(0, std::memory_order_relaxed);
+                for (auto& count : m_histogram)
+                {
+                    count.store(0, std::memory_order_relaxed);
+                }
+            }
+        private:
+            static std::size_t bucket(std::int64_t nanoseconds) noexcept
+            {
+                if (nanoseconds <= 0)
+                {
+                    return 0;
+                }
+                auto width = static_cast<std::size_t>(
+                    std::bit_width(static_cast<std::uint64_t>(nanoseconds)));
+                return width > latencyBuckets ? latencyBuckets - 1 : width - 1;
+            }
+            std::atomic<std::uint64_t> m_invocations { 0 };
+            std::atomic<std::int64_t> m_nanoseconds { 0 };
+            std::array<std::atomic<std::uint64_t>, latencyBuckets> m_histogram {};
+    };
+
+    /// @brief Times a call, and records it in a HandlerCounters object when destroyed.
+    ///
+    /// Calls that throw exceptions are recorded too.
+    class HandlerTimer
+    {
+        public:
+            /// @brief Start timing a call.
+            /// @param counters The counters to record the call in.
+            explicit HandlerTimer(HandlerCounters& counters) noexcept
+                : m_counters(counters), m_start(HandlerCounters::clock_t::now()) {}
+            /// @brief Copy constructor
+            HandlerTimer(const HandlerTimer&) = delete;
+            /// @brief Destructor. Records the call.
+            ~HandlerTimer()
+            {
+                m_counters.record(HandlerCounters::clock_t::now() - m_start);
+            }
+            /// @brief Copy equals operator
+            HandlerTimer& operator =(const HandlerTimer&) = delete;
+        private:
+            HandlerCounters& m_counters;
+            HandlerCounters::clock_t::time_point m_start;
+    };
+}
@@ -0,0 +1,57 @@
+/// @file MethodBinding.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace jimo
+{
+    /// @brief A callable that calls a method on an object.
+    ///
+    /// The object pointer and method pointer are stored as a pair, so two MethodBindings
+    /// compare equal when they call the same method on the same object. This is how
+    /// Delegate and StaticDelegate store methods, and how they find them again for -=.
+    /// @tparam result_t The result type returned by the method.
+    /// @tparam object_t The type of the object. It is const for const methods.
+    /// @tparam method_t The pointer to member function type of the method.
+    template<typename result_t, typename object_t, typename method_t>
+    struct MethodBinding
+    {
+        /// @brief The object to call the method on.
+        object_t* object;
+        /// @brief The method to call.
+        method_t method;
+        /// @brief Call the method.
+        /// @tparam call_arguments_t The types of the arguments.
+        /// @param ...args The arguments to pass to the method.
+        /// @return The value returned by the method.
+        template<typename... call_arguments_t>
+        result_t operator ()(call_arguments_t&&... args) const
+        {
+            return (object->*method)(std::forward<call_arguments_t>(args)...);
+        }
+        /// @brief Compare two MethodBindings for equality.
+        /// @return true if both call the same method on the same object.
+        bool operator ==(const MethodBinding&) const noexcept = default;
+    };
+}
+
+/// @brief Hashes a MethodBinding by its object.
+///
+/// Pointers to member functions cannot be hashed portably, so MethodBindings for different
+/// methods of the same object have the same hash.
+template<typename result_t, typename object_t, typename method_t>
+struct std::hash<jimo::MethodBinding<result_t, object_t, method_t>>
+{
+    /// @brief Hash a MethodBinding.
+    /// @param binding The MethodBinding to hash.
+    /// @return The hash of the MethodBinding's object pointer.
+    std::size_t operator ()(
+        const jimo::MethodBinding<result_t, object_t, method_t>& binding) const noexcept
+    {
+        return std::hash<const volatile void*>()(binding.object);
+    }
+};
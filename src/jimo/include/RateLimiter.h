@@ -0,0 +1,215 @@
+/// @file RateLimiter.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Connection.h"
+#include "Event.h"
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace jimo::timing
+{
+    /// @brief Which events in a burst a Debounce or Throttle forwards.
+    enum class Edge
+    {
+        /// @brief Forward the first event of a burst or window immediately.
+        Leading,
+        /// @brief Forward the last event of a burst or window when it ends.
+        Trailing,
+        /// @brief Forward the first event immediately, and the last event when the burst
+        /// or window ends, if there were more events after the first.
+        Both,
+    };
+
+    /// @brief The base class for Debounce and Throttle.
+    ///
+    /// A RateLimiter subscribes to a source Event and forwards some of the source's events
+    /// through its own forwarded Event. Events that are not forwarded are coalesced: only
+    /// the most recent one is kept, and it is forwarded by the trailing edge.
+    ///
+    /// Leading events are forwarded on the thread that fires the source Event. Trailing
+    /// events are forwarded on a thread that belongs to the RateLimiter, and are passed a
+    /// copy of the event args. The sender must remain valid until its events have been
+    /// forwarded, and the source Event must not be fired while the RateLimiter is being
+    /// destroyed.
+    /// @tparam sender_t The type of the object that fires the source Event.
+    /// @tparam eventArgs_t The type of the event arguments.
+    /// @tparam clock_t A std::chrono clock.
+    template<typename sender_t, typename eventArgs_t, typename clock_t = std::chrono::steady_clock>
+    requires std::chrono::is_clock_v<clock_t> && std::copy_constructible<eventArgs_t>
+    class RateLimiter
+    {
+        public:
+            /// @brief The Event that events are forwarded through.
+            Event<sender_t, eventArgs_t> forwarded;
+            /// @brief Copy constructor
+            RateLimiter(const RateLimiter&) = delete;
+            /// @brief Move constructor
+            RateLimiter(RateLimiter&&) = delete;
+            /// @brief Destructor. Unsubscribes from the source Event. Events that are waiting
+            /// for the trailing edge are discarded.
+            virtual ~RateLimiter() noexcept
+            {
+                m_connection.disconnect();
+                if (m_trailingThread.joinable())
+                {
+                    m_trailingThread.request_stop();
+                    m_trailingThread.join();
+                }
+            }
+            /// @brief Copy equals operator
+            RateLimiter& operator =(const RateLimiter&) = delete;
+            /// @brief Move equals operator
+            RateLimiter& operator =(RateLimiter&&) = delete;
+            /// @brief Retrieve the length of the burst or window.
+            /// @return The window.
+            typename clock_t::duration window() const noexcept { return m_window; }
+            /// @brief Retrieve which events are forwarded.
+            /// @return The edge.
+            Edge edge() const noexcept { return m_edge; }
+        protected:
+            /// @brief Constructor
+            /// @param source The Event to subscribe to.
+            /// @param window The length of the burst or window.
+            /// @param edge Which events to forward.
+            /// @param restart true if each event extends the window, as in Debounce; false if
+            /// the window has a fixed length, as in Throttle.
+            RateLimiter(Event<sender_t, eventArgs_t>& source, typename clock_t::duration window,
+                Edge edge, bool restart)
+                : m_window(window), m_edge(edge), m_restart(restart)
+            {
+                if (m_edge != Edge::Leading)
+                {
+                    m_trailingThread = std::jthread([this](std::stop_token stopToken) {
+                        forwardTrailing(stopToken);
+                    });
+                }
+                m_connection = source.subscribe([this](sender_t& sender, eventArgs_t& e) {
+                    receive(sender, e);
+                });
+            }
+        private:
+            void receive(sender_t& sender, eventArgs_t& e)
+            {
+                auto now = clock_t::now();
+                std::unique_lock<std::mutex> lock(m_lock);
+                auto idle = now >= m_deadline && !m_pending;
+                if (idle || m_restart)
+                {
+                    m_deadline = now + m_window;
+                }
+                if (idle && m_edge != Edge::Trailing)
+                {
+                    lock.unlock();
+                    forwarded(sender, e);
+                    return;
+                }
+                if (m_edge != Edge::Leading)
+                {
+                    m_sender = &sender;
+                    m_pending.emplace(e);
+                    m_changed.notify_one();
+                }
+            }
+            void forwardTrailing(std::stop_token stopToken)
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                while (m_changed.wait(lock, stopToken, [this]() { return m_pending.has_value(); }))
+                {
+                    // The deadline moves whenever a Debounce receives an event, so wait
+                    // until it has passed without moving.
+                    while (clock_t::now() < m_deadline)
+                    {
+                        m_changed.wait_until(lock, stopToken, m_deadline, []() { return false; });
+                        if (stopToken.stop_requested())
+                        {
+                            return;
+                        }
+                    }
+                    auto e = std::move(*m_pending);
+                    m_pending.reset();
+                    auto sender = m_sender;
+                    if (!m_restart)
+                    {
+                        // The trailing event starts a new throttle window.
+                        m_deadline = clock_t::now() + m_window;
+                    }
+                    lock.unlock();
+                    forwarded(*sender, e);
+                    lock.lock();
+                }
+            }
+
+            const typename clock_t::duration m_window;
+            const Edge m_edge;
+            const bool m_restart;
+            std::mutex m_lock;
+            std::condition_variable_any m_changed;
+            typename clock_t::time_point m_deadline {};
+            sender_t* m_sender = nullptr;
+            std::optional<eventArgs_t> m_pending;
+            ScopedConnection m_connection;
+            std::jthread m_trailingThread;
+    };
+
+    /// @brief Forwards an Event's events only once they stop arriving.
+    ///
+    /// A burst is a series of events that are each less than window apart. With Edge::Leading,
+    /// the first event of each burst is forwarded. With Edge::Trailing, the last event of
+    /// each burst is forwarded once window has passed without another event. Edge::Both
+    /// forwards both.
+    ///
+    /// For example, to handle a text box's changed event only after the user stops typing:
+    /// <code>Debounce<TextBox, EventArgs> debounced(box.changed, 300ms);</code>
+    /// and then subscribe to <code>debounced.forwarded</code>.
+    /// @see RateLimiter
+    /// @tparam sender_t The type of the object that fires the source Event.
+    /// @tparam eventArgs_t The type of the event arguments.
+    /// @tparam clock_t A std::chrono clock.
+    template<typename sender_t, typename eventArgs_t, typename clock_t = std::chrono::steady_clock>
+    class Debounce : public RateLimiter<sender_t, eventArgs_t, clock_t>
+    {
+        public:
+            /// @brief Constructor
+            /// @param source The Event to subscribe to.
+            /// @param window The time without events that ends a burst.
+            /// @param edge Which events to forward.
+            Debounce(Event<sender_t, eventArgs_t>& source, typename clock_t::duration window,
+                Edge edge = Edge::Trailing)
+                : RateLimiter<sender_t, eventArgs_t, clock_t>(source, window, edge, true) {}
+    };
+
+    /// @brief Forwards at most one of an Event's events in each window.
+    ///
+    /// A window starts when an event is forwarded, and lasts for window. With Edge::Leading,
+    /// an event that arrives when no window is open is forwarded immediately, and the events
+    /// in the window are dropped. With Edge::Trailing, the last event in each window is
+    /// forwarded when the window ends. Edge::Both forwards the first event immediately and
+    /// the last event in each window when it ends.
+    ///
+    /// For example, to redraw a progress bar at most 30 times a second however often
+    /// progress is reported:
+    /// <code>Throttle<Worker, ProgressEventArgs> throttled(worker.progress, 33ms, Edge::Both);</code>
+    /// @see RateLimiter
+    /// @tparam sender_t The type of the object that fires the source Event.
+    /// @tparam eventArgs_t The type of the event arguments.
+    /// @tparam clock_t A std::chrono clock.
+    template<typename sender_t, typename eventArgs_t, typename clock_t = std::chrono::steady_clock>
+    class Throttle : public RateLimiter<sender_t, eventArgs_t, clock_t>
+    {
+        public:
+            /// @brief Constructor
+            /// @param source The Event to subscribe to.
+            /// @param window The length of each window.
+            /// @param edge Which events to forward.
+            Throttle(Event<sender_t, eventArgs_t>& source, typename clock_t::duration window,
+                Edge edge = Edge::Leading)
+                : RateLimiter<sender_t, eventArgs_t, clock_t>(source, window, edge, false) {}
+    };
+}
@@ -0,0 +1,526 @@
+/// @file SharedEventChannel.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Connection.h"
+#include "Event.h"
+#include "EventRecorder.h"
+#include "Object.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+/// @brief The namespace for classes that pass events between processes.
+namespace jimo::interprocess
+{
+    /// @brief A named block of memory that can be mapped by several processes.
+    ///
+    /// The memory is created with shm_open, so processes on the same host share it by name.
+    /// The name must begin with a '/' and contain no other '/'. The SharedMemory that
+    /// created the name removes it when it is destroyed; processes that have already
+    /// opened the memory can continue to use it.
+    ///
+    /// This class is only available on POSIX systems.
+    class SharedMemory
+    {
+        public:
+            /// @brief Create shared memory of a fixed size, filled with zeros.
+            ///
+            /// Any existing shared memory with the same name is replaced.
+            /// @param name The name of the shared memory.
+            /// @param size The size of the memory in bytes.
+            /// @exception std::system_error if the memory cannot be created or mapped.
+            SharedMemory(const std::string& name, std::size_t size) : m_name(name), m_owner(true)
+            {
+                ::shm_unlink(name.c_str());
+                auto file = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+                if (file < 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "Cannot create " + name);
+                }
+                if (::ftruncate(file, static_cast<off_t>(size)) != 0)
+                {
+                    auto error = errno;
+                    ::close(file);
+                    ::shm_unlink(name.c_str());
+                    throw std::system_error(error, std::generic_category(), "Cannot size " + name);
+                }
+                map(file, size);
+            }
+            /// @brief Open existing shared memory.
+            /// @param name The name of the shared memory.
+            /// @exception std::system_error if the memory does not exist or cannot be mapped.
+            explicit SharedMemory(const std::string& name) : m_name(name), m_owner(false)
+            {
+                auto file = ::shm_open(name.c_str(), O_RDWR, 0);
+                if (file < 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "Cannot open " + name);
+                }
+                struct stat status;
+                if (::fstat(file, &status) != 0)
+                {
+                    auto error = errno;
+                    ::close(file);
+                    throw std::system_error(error, std::generic_category(), "Cannot stat " + name);
+                }
+                map(file, static_cast<std::size_t>(status.st_size));
+            }
+            /// @brief Copy constructor
+            SharedMemory(const SharedMemory&) = delete;
+            /// @brief Move constructor
+            /// @param other The SharedMemory to move. It maps nothing after the move.
+            SharedMemory(SharedMemory&& other) noexcept
+                : m_name(std::move(other.m_name)), m_owner(std::exchange(other.m_owner, false)),
+                m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+            /// @brief Destructor. Unmaps the memory, and removes its name if this object
+            /// created it.
+            ~SharedMemory() { release(); }
+            /// @brief Copy equals operator
+            SharedMemory& operator =(const SharedMemory&) = delete;
+            /// @brief Move equals operator
+            /// @param other The SharedMemory to move. It maps nothing after the move.
+            /// @return This SharedMemory.
+            SharedMemory& operator =(SharedMemory&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    release();
+                    m_name = std::move(other.m_name);
+                    m_owner = std::exchange(other.m_owner, false);
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                }
+                return *this;
+            }
+            /// @brief Retrieve the mapped memory.
+            /// @return The memory.
+            std::span<std::byte> data() const noexcept
+            {
+                return { static_cast<std::byte*>(m_data), m_size };
+            }
+        private:
+            void map(int file, std::size_t size)
+            {
+                if (size != 0)
+                {
+                    auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+                    if (data == MAP_FAILED)
+                    {
+                        auto error = errno;
+                        ::close(file);
+                        release();
+                        throw std::system_error(error, std::generic_category(), "Cannot map " + m_name);
+                    }
+                    m_data = data;
+                    m_size = size;
+                }
+                ::close(file);
+            }
+            void release() noexcept
+            {
+                if (m_data)
+                {
+                    ::munmap(m_data, m_size);
+                    m_data = nullptr;
+                }
+                if (m_owner)
+                {
+                    ::shm_unlink(m_name.c_str());
+                    m_owner = false;
+                }
+            }
+
+            std::string m_name;
+            bool m_owner;
+            void* m_data = nullptr;
+            std::size_t m_size = 0;
+    };
+
+    /// @brief A ring buffer in shared memory that carries the args of an event from the
+    /// processes that publish it to every process that receives it.
+    ///
+    /// One process creates the channel by name; others open it. Each SharedEventChannel can
+    /// both publish and receive. Publishing reserves a slot with one atomic increment,
+    /// serializes the args directly into it, and wakes receivers only if one is sleeping,
+    /// so it does not make a system call while receivers are busy. Each SharedEventChannel
+    /// receives every event published after it was constructed, by any process, and fires
+    /// its received Event with them: call poll to dispatch the waiting events, wait to
+    /// block until there are some, or run to do both on a dedicated thread. wait spins
+    /// briefly before it sleeps, so an event published to a receiver that is waiting is
+    /// usually handled within a few microseconds.
+    ///
+    /// The channel is a broadcast: publishers never wait for receivers. A receiver that
+    /// falls more than capacity() events behind loses the oldest ones, and dropped() counts
+    /// them. Each slot holds at most maxArgsSize() bytes of serialized args. Serializers in
+    /// all of the processes must agree on the format.
+    ///
+    /// Any number of threads may publish through the same SharedEventChannel. Only one
+    /// thread at a time may receive through it; give each receiving thread its own
+    /// SharedEventChannel. A publisher that stops while it is writing a slot stops every
+    /// publisher when the ring wraps around to that slot.
+    ///
+    /// This class is only available on POSIX systems. Receivers sleep on a futex on Linux,
+    /// and poll every 50 microseconds on other systems.
+    /// @tparam eventArgs_t The type of the event args.
+    /// @tparam serializer_t A recording::Serializer that converts the args to and from bytes.
+    template<typename eventArgs_t, typename serializer_t = recording::EmptySerializer<eventArgs_t>>
+    requires recording::Serializer<serializer_t, eventArgs_t>
+    class SharedEventChannel : public Object
+    {
+        public:
+            /// @brief The layout of the shared memory.
+            ///
+            /// The header is followed by capacity slots of slotSize bytes each. A slot begins
+            /// with its sequence: the position of the event that it holds, plus one, or 0
+            /// while an event is being written to it. The sequence is followed by the size
+            /// of the serialized args, as a std::uint64_t, and then by the args.
+            struct header
+            {
+                /// @brief Identifies the memory as a channel. It is written last, when the
+                /// rest of the header is ready.
+                std::atomic<std::uint64_t> magic;
+                /// @brief The number of slots. A power of two.
+                std::uint64_t capacity;
+                /// @brief The size of each slot in bytes.
+                std::uint64_t slotSize;
+                /// @brief The position that the next event is published at.
+                alignas(64) std::atomic<std::uint64_t> tail;
+                /// @brief Incremented to wake sleeping receivers.
+                alignas(64) std::atomic<std::uint32_t> signal;
+                /// @brief The number of receivers that are sleeping, or about to sleep.
+                std::atomic<std::uint32_t> sleepers;
+            };
+            /// @brief The value of header::magic.
+            static constexpr std::uint64_t magic = 0x316e6863'6f6d696a; // "jimochn1"
+            /// @brief The number of times that wait checks for events before it sleeps.
+            static constexpr int spinCount = 20000;
+
+            /// @brief Create a channel.
+            ///
+            /// Any existing channel with the same name is replaced. The channel's name is
+            /// removed when this object is destroyed.
+            /// @param name The name of the shared memory that holds the channel. See SharedMemory.
+            /// @param capacity The number of events that the channel holds. It is rounded up
+            /// to a power of two.
+            /// @param maxArgsSize The largest number of bytes that the serialized args may use.
+            /// @param serializer The serializer for the args.
+            /// @exception std::invalid_argument if capacity is zero.
+            /// @exception std::system_error if the shared memory cannot be created.
+            SharedEventChannel(const std::string& name, std::size_t capacity, std::size_t maxArgsSize,
+                serializer_t serializer = serializer_t())
+                : m_memory(name, memorySize(checked(capacity), maxArgsSize)), m_serializer(serializer)
+            {
+                auto layout = ::new (m_memory.data().data()) header {};
+                layout->capacity = std::bit_ceil(capacity);
+                layout->slotSize = slotSizeFor(maxArgsSize);
+                // Positions start at capacity, so that every slot's sequence can hold the
+                // position of the previous event in it, plus one, and 0 never does.
+                layout->tail.store(layout->capacity, std::memory_order_relaxed);
+                for (std::uint64_t index = 0; index < layout->capacity; ++index)
+                {
+                    ::new (m_memory.data().data() + sizeof(header) + index * layout->slotSize)
+                        std::atomic<std::uint64_t>(index + 1);
+                }
+                layout->magic.store(magic, std::memory_order_release);
+                attach();
+            }
+            /// @brief Open a channel that another SharedEventChannel created.
+            /// @param name The name of the shared memory that holds the channel.
+            /// @param serializer The serializer for the args.
+            /// @exception std::system_error if the shared memory cannot be opened.
+            /// @exception std::invalid_argument if the shared memory does not hold a channel.
+            explicit SharedEventChannel(const std::string& name, serializer_t serializer = serializer_t())
+                : m_memory(name), m_serializer(serializer)
+            {
+                auto memory = m_memory.data();
+                if (memory.size() < sizeof(header) ||
+                    reinterpret_cast<header*>(memory.data())->magic.load(std::memory_order_acquire) != magic)
+                {
+                    throw std::invalid_argument("The shared memory does not contain an event channel.");
+                }
+                auto layout = reinterpret_cast<header*>(memory.data());
+                if (memory.size() < sizeof(header) + layout->capacity * layout->slotSize)
+                {
+                    throw std::invalid_argument("The event channel is too small.");
+                }
+                attach();
+            }
+            /// @brief Copy constructor
+            SharedEventChannel(const SharedEventChannel&) = delete;
+            /// @brief Move constructor
+            SharedEventChannel(SharedEventChannel&&) = delete;
+            /// @brief Destructor
+            virtual ~SharedEventChannel() noexcept = default;
+            /// @brief Copy equals operator
+            SharedEventChannel& operator =(const SharedEventChannel&) = delete;
+            /// @brief Move equals operator
+            SharedEventChannel& operator =(SharedEventChannel&&) = delete;
+
+            /// @brief Fired by poll for each event received from the channel.
+            Event<SharedEventChannel, eventArgs_t> received;
+
+            /// @brief Publish an event to every process that receives from the channel.
+            /// @param e The event args.
+            /// @exception std::length_error if the serialized args are larger than
+            /// maxArgsSize().
+            void publish(const eventArgs_t& e)
+            {
+                std::size_t size = m_serializer.size(e);
+                if (size > maxArgsSize())
+                {
+                    throw std::length_error("The event args are too large for the channel.");
+                }
+                auto position = m_header->tail.fetch_add(1, std::memory_order_relaxed);
+                auto slot = slotAt(position);
+                // Wait for the publisher of the event that was in the slot one lap ago.
+                auto previous = position - capacity() + 1;
+                while (sequence(slot).load(std::memory_order_acquire) != previous)
+                {
+                    std::this_thread::yield();
+                }
+                sequence(slot).store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                std::uint64_t length = size;
+                std::memcpy(slot + sizeof(std::uint64_t), &length, sizeof(length));
+                m_serializer.write(e, { slot + 2 * sizeof(std::uint64_t), size });
+                sequence(slot).store(position + 1, std::memory_order_release);
+                // Pairs with the fence in wait, so that either the receiver sees the event or
+                // this thread sees that the receiver is sleeping.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_header->sleepers.load(std::memory_order_relaxed) != 0)
+                {
+                    notify();
+                }
+            }
+            /// @brief Publish every invocation of an Event to the channel.
+            ///
+            /// The publishing handler is added with the highest priority, so that it
+            /// publishes each invocation before any other handler can halt it.
+            /// @tparam sender_t The type of the Event's sender. It is not published.
+            /// @param event The Event.
+            /// @return The Connection for the publishing handler. Disconnect it before this
+            /// SharedEventChannel is destroyed.
+            template<typename sender_t>
+            Connection forward(Event<sender_t, eventArgs_t>& event)
+            {
+                return event.subscribe({ [this](sender_t&, eventArgs_t& e) { publish(e); },
+                    std::numeric_limits<int>::max() });
+            }
+            /// @brief Fire received for the events that have been published since the last
+            /// call, in the order of publication.
+            /// @param maxEvents The largest number of events to dispatch.
+            /// @return The number of events that were dispatched.
+            std::size_t poll(std::size_t maxEvents = std::numeric_limits<std::size_t>::max())
+            {
+                std::size_t count = 0;
+                while (count < maxEvents)
+                {
+                    auto slot = slotAt(m_position);
+                    auto expected = m_position + 1;
+                    auto current = sequence(slot).load(std::memory_order_acquire);
+                    if (current == expected)
+                    {
+                        // The publisher of a later lap may overwrite the slot while it is
+                        // copied, so the copy is only used if the sequence is unchanged.
+                        std::uint64_t length;
+                        std::memcpy(&length, slot + sizeof(std::uint64_t), sizeof(length));
+                        length = std::min<std::uint64_t>(length, m_args.size());
+                        std::memcpy(m_args.data(), slot + 2 * sizeof(std::uint64_t), length);
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (sequence(slot).load(std::memory_order_relaxed) == expected)
+                        {
+                            ++m_position;
+                            auto e = m_serializer.read({ m_args.data(), length });
+                            received(*this, e);
+                            ++count;
+                            continue;
+                        }
+                    }
+                    else if (current != 0 && current < expected)
+                    {
+                        break;
+                    }
+                    auto tail = m_header->tail.load(std::memory_order_acquire);
+                    if (tail - m_position <= capacity() && current == 0)
+                    {
+                        // The event is still being written.
+                        break;
+                    }
+                    // The slot has been reused, so skip the events that were overwritten.
+                    auto oldest = std::max(m_position + 1, tail - capacity());
+                    m_dropped += oldest - m_position;
+                    m_position = oldest;
+                }
+                return count;
+            }
+            /// @brief Wait until there are events for poll to dispatch.
+            /// @param timeout The longest time to wait.
+            /// @return true if there are events, false if the timeout expired.
+            bool wait(std::chrono::nanoseconds timeout)
+            {
+                for (int spin = 0; spin < spinCount; ++spin)
+                {
+                    if (pending())
+                    {
+                        return true;
+                    }
+                }
+                auto deadline = std::chrono::steady_clock::now() + timeout;
+                while (true)
+                {
+                    auto signal = m_header->signal.load(std::memory_order_acquire);
+                    m_header->sleepers.fetch_add(1, std::memory_order_relaxed);
+                    // Pairs with the fence in publish.
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    auto ready = pending();
+                    auto remaining = deadline - std::chrono::steady_clock::now();
+                    if (!ready && remaining > std::chrono::nanoseconds::zero())
+                    {
+                        sleep(signal, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+                    }
+                    m_header->sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    if (ready || pending())
+                    {
+                        return true;
+                    }
+                    if (std::chrono::steady_clock::now() >= deadline)
+                    {
+                        return false;
+                    }
+                }
+            }
+            /// @brief Dispatch events as they arrive until a stop is requested.
+            ///
+            /// This is typically the body of a std::jthread:
+            /// <code>std::jthread receiver([&channel](std::stop_token stop) { channel.run(stop); });</code>
+            /// @param stopToken The token that stops the loop.
+            void run(std::stop_token stopToken)
+            {
+                std::stop_callback wake(stopToken, [this]() { notify(); });
+                while (!stopToken.stop_requested())
+                {
+                    if (poll() == 0)
+                    {
+                        wait(std::chrono::milliseconds(100));
+                    }
+                }
+            }
+            /// @brief Retrieve the number of events that this receiver lost because it fell
+            /// more than capacity() events behind.
+            /// @return The number of dropped events.
+            std::uint64_t dropped() const noexcept { return m_dropped; }
+            /// @brief Retrieve the number of events that the channel holds.
+            /// @return The capacity.
+            std::size_t capacity() const noexcept { return m_header->capacity; }
+            /// @brief Retrieve the largest size of the serialized args.
+            /// @return The size in bytes.
+            std::size_t maxArgsSize() const noexcept
+            {
+                return m_header->slotSize - 2 * sizeof(std::uint64_t);
+            }
+        private:
+            static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                std::atomic<std::uint32_t>::is_always_lock_free,
+                "Shared memory requires lock-free atomics.");
+
+            static std::size_t checked(std::size_t capacity)
+            {
+                if (capacity == 0)
+                {
+                    throw std::invalid_argument("capacity must be greater than 0.");
+                }
+                return capacity;
+            }
+            static std::size_t slotSizeFor(std::size_t maxArgsSize) noexcept
+            {
+                // Slots are a whole number of cache lines, so publishers writing adjacent
+                // slots do not share a line.
+                return (2 * sizeof(std::uint64_t) + maxArgsSize + 63) / 64 * 64;
+            }
+            static std::size_t memorySize(std::size_t capacity, std::size_t maxArgsSize) noexcept
+            {
+                return sizeof(header) + std::bit_ceil(capacity) * slotSizeFor(maxArgsSize);
+            }
+            static std::atomic<std::uint64_t>& sequence(std::byte* slot) noexcept
+            {
+                return *std::launder(reinterpret_cast<std::atomic<std::uint64_t>*>(slot));
+            }
+
+            void attach()
+            {
+                m_header = reinterpret_cast<header*>(m_memory.data().data());
+                m_slots = m_memory.data().data() + sizeof(header);
+                m_args.resize(maxArgsSize());
+                m_position = m_header->tail.load(std::memory_order_acquire);
+            }
+            std::byte* slotAt(std::uint64_t position) const noexcept
+            {
+                return m_slots + (position & (m_header->capacity - 1)) * m_header->slotSize;
+            }
+            bool pending() const noexcept
+            {
+                return m_header->tail.load(std::memory_order_acquire) != m_position;
+            }
+            void notify() noexcept
+            {
+                m_header->signal.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+                ::syscall(SYS_futex, &m_header->signal, FUTEX_WAKE, std::numeric_limits<int>::max(),
+                    nullptr, nullptr, 0);
+#endif
+            }
+            void sleep(std::uint32_t signal, std::chrono::nanoseconds timeout) noexcept
+            {
+#if defined(__linux__)
+                // A shared, not private, futex, so that publishers in other processes can
+                // wake it.
+                auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+                timespec remaining { static_cast<std::time_t>(seconds.count()),
+                    static_cast<long>((timeout - seconds).count()) };
+                ::syscall(SYS_futex, &m_header->signal, FUTEX_WAIT, signal, &remaining, nullptr, 0);
+#else
+                if (m_header->signal.load(std::memory_order_acquire) == signal)
+                {
+                    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout,
+                        std::chrono::microseconds(50)));
+                }
+#endif
+            }
+
+            SharedMemory m_memory;
+            serializer_t m_serializer;
+            header* m_header = nullptr;
+            std::byte* m_slots = nullptr;
+            std::vector<std::byte> m_args;
+            std::uint64_t m_position = 0;
+            std::uint64_t m_dropped = 0;
+    };
+}
+#endif
@@ -0,0 +1,287 @@
+/// @file StaticDelegate.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Combiners.h"
+#include "InplaceFunction.h"
+#include "MethodBinding.h"
+
+namespace jimo
+{
+    /// @brief A Delegate that holds up to a fixed number of functions and never allocates
+    /// memory.
+    ///
+    /// StaticDelegate has the same +=, -=, and invocation operations as Delegate, but
+    /// stores its functions in an array inside the object, so it can be used where heap
+    /// allocation is not possible, or is too expensive. Adding a function to a full
+    /// StaticDelegate throws std::length_error.
+    ///
+    /// Unlike Delegate, this class is not thread safe. It contains no mutex, so all
+    /// operations on a StaticDelegate object must be made from one thread, or be
+    /// synchronized by the caller.
+    /// @sa StaticEvent which is a specific type of StaticDelegate.
+    /// @tparam capacity The maximum number of functions.
+    /// @tparam result_t The result type that is returned from the functions.
+    /// @tparam arguments_t The argument types for any parameters for functions represented
+    /// by the StaticDelegate.
+    template<std::size_t capacity, typename result_t, typename... arguments_t>
+    class StaticDelegate
+    {
+        public:
+            /// @brief function_t pointer type
+            using function_t = InplaceFunction<result_t(arguments_t...)>;
+            /// @brief Initializes an empty StaticDelegate
+            StaticDelegate() = default;
+            /// @brief Constructs a StaticDelegate object from a function, static class method,
+            /// Functor, or lambda.
+            /// @param function The function to place as the first function in the new object.
+            StaticDelegate(const function_t& function)
+            {
+                *this += function;
+            }
+            /// @brief Construct StaticDelegate object from initializer_list of functions,
+            /// static class methods, Functors, and lambdas.
+            /// @param functions The functions to create the StaticDelegate object from.
+            /// @exception std::length_error if there are more than capacity functions.
+            StaticDelegate(const std::initializer_list<const function_t>& functions)
+            {
+                for (const auto& function : functions)
+                {
+                    *this += function;
+                }
+            }
+            /// @brief Constructor that takes a const method with any number of parameters
+            /// @tparam object_t The type of the class containing the method.
+            /// @tparam method_arguments_t The method's parameter types.
+            /// @param object The class instance for the method.
+            /// @param method The method to call.
+            template<typename object_t, typename... method_arguments_t>
+            requires std::is_class_v<object_t>
+            StaticDelegate(const object_t& object,
+                result_t(object_t::*method)(method_arguments_t...) const)
+            {
+                *this += MethodBinding<result_t, const object_t, decltype(method)>{ &object, method };
+            }
+            /// @brief Constructor that takes a non-const method with any number of parameters
+            /// @tparam object_t The type of the class containing the method.
+            /// @tparam method_arguments_t The method's parameter types.
+            /// @param object The class instance for the method.
+            /// @param method The method to call.
+            template<typename object_t, typename... method_arguments_t>
+            requires std::is_class_v<object_t>
+            StaticDelegate(const object_t& object,
+                result_t(object_t::*method)(method_arguments_t...))
+            {
+                *this += MethodBinding<result_t, object_t, decltype(method)>{
+                    const_cast<object_t*>(&object), method };
+            }
+            /// @brief Destructor
+            virtual ~StaticDelegate() = default;
+            /// @brief Remove all functions from the StaticDelegate
+            void clear() noexcept
+            {
+                for (std::size_t index = 0; index < m_size; ++index)
+                {
+                    m_functions[index] = nullptr;
+                }
+                m_size = 0;
+            }
+            /// @brief Return if the StaticDelegate is empty.
+            /// @return true if the StaticDelegate is empty, false otherwise.
+            bool empty() const noexcept { return m_size == 0; }
+            /// @brief Return if the StaticDelegate is full.
+            /// @return true if no more functions can be added, false otherwise.
+            bool full() const noexcept { return m_size == capacity; }
+            /// @brief Retrieve the number of functions in the StaticDelegate object
+            /// @return The number of functions
+            std::size_t size() const noexcept { return m_size; }
+            /// @brief Retrieve the maximum number of functions.
+            /// @return The capacity of the StaticDelegate.
+            static constexpr std::size_t max_size() noexcept { return capacity; }
+            /// @brief Invoke the methods represented by the current StaticDelegate.
+            /// @param ...args The parameters to pass to each method.
+            /// @return The return value from the last method call.
+            result_t invoke(arguments_t... args) const
+            {
+                return operator ()(std::forward<arguments_t>(args)...);
+            }
+            /// @brief Invoke the methods, and fold their results with a combiner.
+            /// @see Delegate::invokeWith
+            /// @tparam combiner_t The combiner type. It must satisfy jimo::combiners::Combiner.
+            /// @param combiner The combiner.
+            /// @param ...args The parameters to pass to each method.
+            /// @return A copy of the value returned by the combiner's result method. It is
+            /// returned by value so that it outlives a temporary combiner.
+            template<typename combiner_t>
+            requires (!std::is_void_v<result_t>) &&
+                combiners::Combiner<std::remove_cvref_t<combiner_t>, result_t>
+            std::remove_cvref_t<decltype(std::declval<combiner_t&>().result())>
+                invokeWith(combiner_t&& combiner, arguments_t... args) const
+            {
+                for (std::size_t index = 0; index < m_size; ++index)
+                {
+                    if (!combiner(m_functions[index].call(shareArgument<arguments_t>(args)...)))
+                    {
+                        break;
+                    }
+                }
+                return combiner.result();
+            }
+            /// @brief Compare two StaticDelegates for equality
+            /// @param other The second StaticDelegate object to compare to this
+            /// @return true if other contains the same functions in the same order,
+            /// false otherwise.
+            template<std::size_t otherCapacity>
+            bool operator ==(const StaticDelegate<otherCapacity, result_t, arguments_t...>& other)
+                const noexcept
+            {
+                if (m_size != other.size())
+                {
+                    return false;
+                }
+                for (std::size_t index = 0; index < m_size; ++index)
+                {
+                    if (!m_functions[index].sameTarget(other.m_functions[index]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            /// @brief Add the function specified by the parameter to this object.
+            /// @param function The function to add.
+            /// @return This StaticDelegate.
+            /// @exception std::length_error if the StaticDelegate is full.
+            StaticDelegate& operator +=(const function_t& function)
+            {
+                if (full())
+                {
+                    throw std::length_error("StaticDelegate is full.");
+                }
+                m_functions[m_size++] = function;
+                return *this;
+            }
+            /// @brief Add the functions in another StaticDelegate object to this object
+            ///
+            /// This overload allows a method to be added with
+            /// <code>delegate += { object, &Class::method };</code>
+            /// @param delegate The StaticDelegate object whose functions are to be added.
+            /// @return This StaticDelegate.
+            /// @exception std::length_error if there is not room for all of the functions.
+            StaticDelegate& operator +=(const StaticDelegate& delegate)
+            {
+                return operator +=<capacity>(delegate);
+            }
+            /// @brief Add the functions in another StaticDelegate object to this object
+            /// @param delegate The StaticDelegate object whose functions are to be added.
+            /// @return This StaticDelegate.
+            /// @exception std::length_error if there is not room for all of the functions.
+            /// No functions are added in that case.
+            template<std::size_t otherCapacity>
+            StaticDelegate& operator +=(
+                const StaticDelegate<otherCapacity, result_t, arguments_t...>& delegate)
+            {
+                const auto count = delegate.size();
+                if (count > capacity - m_size)
+                {
+                    throw std::length_error("StaticDelegate is full.");
+                }
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    m_functions[m_size++] = delegate.m_functions[index];
+                }
+                return *this;
+            }
+            /// @brief Remove the function specified by the parameter from this object.
+            /// @param function The function to remove.
+            /// @return This StaticDelegate.
+            StaticDelegate& operator -=(const function_t& function) noexcept
+            {
+                std::size_t kept = 0;
+                for (std::size_t index = 0; index < m_size; ++index)
+                {
+                    if (!m_functions[index].sameTarget(function))
+                    {
+                        if (kept != index)
+                        {
+                            m_functions[kept] = std::move(m_functions[index]);
+                        }
+                        ++kept;
+                    }
+                }
+                for (std::size_t index = kept; index < m_size; ++index)
+                {
+                    m_functions[index] = nullptr;
+                }
+                m_size = kept;
+                return *this;
+            }
+            /// @brief Remove the functions in another StaticDelegate object from this object
+            ///
+            /// This overload allows a method to be removed with
+            /// <code>delegate -= { object, &Class::method };</code>
+            /// @param delegate The StaticDelegate object containing the functions to remove.
+            /// @return This StaticDelegate.
+            StaticDelegate& operator -=(const StaticDelegate& delegate) noexcept
+            {
+                return operator -=<capacity>(delegate);
+            }
+            /// @brief Remove the functions in another StaticDelegate object from this object
+            /// @param delegate The StaticDelegate object containing the functions to remove.
+            /// @return This StaticDelegate.
+            template<std::size_t otherCapacity>
+            StaticDelegate& operator -=(
+                const StaticDelegate<otherCapacity, result_t, arguments_t...>& delegate) noexcept
+            {
+                if (static_cast<const void*>(this) == static_cast<const void*>(&delegate))
+                {
+                    clear();
+                    return *this;
+                }
+                for (std::size_t index = 0; index < delegate.size(); ++index)
+                {
+                    *this -= delegate.m_functions[index];
+                }
+                return *this;
+            }
+            /// @brief Invokes the functions in the current StaticDelegate object.
+            ///
+            /// Arguments are passed to the functions in the same way as Delegate::operator().
+            /// @return The value returned from executing the last function.
+            virtual result_t operator ()(arguments_t... args) const
+            {
+                if (m_size == 0)
+                {
+                    return result_t();
+                }
+                for (std::size_t index = 0; index < m_size - 1; ++index)
+                {
+                    m_functions[index].call(shareArgument<arguments_t>(args)...);
+                }
+                return m_functions[m_size - 1].call(std::forward<arguments_t>(args)...);
+            }
+        protected:
+            /// @brief Retrieve the functions.
+            ///
+            /// This method is provided so that derived classes can access the functions.
+            /// Only the first size() functions are valid.
+            /// @return The array of functions.
+            const std::array<function_t, capacity>& functions() const noexcept
+            {
+                return m_functions;
+            }
+        private:
+            template<std::size_t, typename, typename...>
+            friend class StaticDelegate;
+
+            std::array<function_t, capacity> m_functions;
+            std::size_t m_size { 0 };
+    };
+}
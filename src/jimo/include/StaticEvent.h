@@ -0,0 +1,54 @@
+/// @file StaticEvent.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "EventArgs.h"
+#include "Object.h"
+#include "StaticDelegate.h"
+#include <concepts>
+#include <cstddef>
+
+namespace jimo
+{
+    /// @brief An Event that holds up to a fixed number of event handlers and never
+    /// allocates memory.
+    ///
+    /// StaticEvent behaves like Event, including halting further processing when an event
+    /// handler calls EventArgs::halt, but is derived from StaticDelegate rather than
+    /// Delegate. Like StaticDelegate, it is not thread safe.
+    /// @tparam capacity The maximum number of event handlers.
+    /// @tparam sender_t The type of the object that invokes the handler.
+    /// @tparam eventArgs_t The type of the event arguments passed to the event handler.
+    /// The type must be either jimo::EventArgs, or a type that is derived from EventArgs.
+    template<std::size_t capacity, typename sender_t, typename eventArgs_t>
+    requires std::derived_from<eventArgs_t, EventArgs>
+    class StaticEvent : public StaticDelegate<capacity, void, sender_t&, eventArgs_t&>
+    {
+        public:
+            /// @brief Constructor
+            StaticEvent() = default;
+            /// @brief Destructor
+            virtual ~StaticEvent() noexcept = default;
+            /// @brief Invoke the methods represented by the current event.
+            /// @param sender The object that called invoke.
+            /// @param e an event args object. It must be derived from EventArgs.
+            virtual void invoke(sender_t& sender, eventArgs_t& e)
+            {
+                operator ()(sender, e);
+            }
+            /// @brief Invoke the methods represented by the current event.
+            /// @param sender The object that called invoke.
+            /// @param e an event args object. It must be derived from EventArgs.
+            virtual void operator ()(sender_t& sender, eventArgs_t& e)
+            {
+                const auto& functions = StaticDelegate<capacity, void, sender_t&, eventArgs_t&>::functions();
+                const auto size = StaticDelegate<capacity, void, sender_t&, eventArgs_t&>::size();
+                for (std::size_t index = 0; index < size; ++index)
+                {
+                    functions[index](sender, e);
+                    if(e.halt()) return;
+                }
+            }
+    };
+}
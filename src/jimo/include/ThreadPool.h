@@ -0,0 +1,183 @@
+/// @file ThreadPool.h
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#pragma once
+#include "Executor.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace jimo::interthread
+{
+    /// @brief An Executor that runs tasks on a fixed number of worker threads.
+    ///
+    /// Tasks that are posted are run in the order they are posted, but tasks run
+    /// concurrently on different threads, so they may complete in any order. The worker
+    /// threads are stopped and joined when the ThreadPool is destroyed; tasks that have not
+    /// started by then are discarded. Tasks must not throw exceptions.
+    class ThreadPool : public Executor
+    {
+        public:
+            /// @brief Constructor
+            /// @param threadCount The number of worker threads. If zero, one thread is used.
+            explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency())
+            {
+                threadCount = std::max<std::size_t>(threadCount, 1);
+                m_threads.reserve(threadCount);
+                for (std::size_t thread = 0; thread < threadCount; ++thread)
+                {
+                    m_threads.emplace_back([this](std::stop_token stopToken) {
+                        runTasks(stopToken);
+                    });
+                }
+            }
+            /// @brief Copy constructor
+            ThreadPool(const ThreadPool&) = delete;
+            /// @brief Move constructor
+            ThreadPool(ThreadPool&&) = delete;
+            /// @brief Destructor. Stops and joins the worker threads.
+            virtual ~ThreadPool() noexcept
+            {
+                for (auto& thread : m_threads)
+                {
+                    thread.request_stop();
+                }
+                m_tasksAvailable.notify_all();
+                m_threads.clear();
+            }
+            /// @brief Copy equals operator
+            ThreadPool& operator =(const ThreadPool&) = delete;
+            /// @brief Move equals operator
+            ThreadPool& operator =(ThreadPool&&) = delete;
+            /// @brief Post a task to be run on one of the worker threads.
+            /// @param task The task to run.
+            void post(task_t task) override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_tasksLock);
+                    m_tasks.push_back(std::move(task));
+                }
+                m_tasksAvailable.notify_one();
+            }
+            /// @brief Retrieve the number of worker threads.
+            /// @return The number of worker threads.
+            std::size_t size() const noexcept { return m_threads.size(); }
+            /// @brief Call a function for each index in [0, count), spreading the calls
+            /// across the worker threads and the calling thread, and wait for all of the
+            /// calls to return.
+            ///
+            /// Indices are started in increasing order. If any call throws, the first
+            /// exception is rethrown once all calls have returned.
+            /// @tparam function_t The type of the function. It is called with a std::size_t index.
+            /// @param count The number of indices.
+            /// @param function The function to call.
+            template<typename function_t>
+            void parallelFor(std::size_t count, function_t&& function)
+            {
+                if (count == 0)
+                {
+                    return;
+                }
+                if (count == 1)
+                {
+                    function(std::size_t { 0 });
+                    return;
+                }
+                // The job is shared with the helper tasks, which may not start until after
+                // every index has been claimed. A helper only calls function for an index that
+                // it claims, and this thread waits for every claimed index to complete, so
+                // function outlives all calls to it.
+                auto job = std::make_shared<parallel_job>(count, &function,
+                    [](void* context, std::size_t index) {
+                        (*static_cast<std::remove_reference_t<function_t>*>(context))(index);
+                    });
+                const auto helpers = std::min(count - 1, size());
+                for (std::size_t helper = 0; helper < helpers; ++helper)
+                {
+                    post([job]() { job->run(); });
+                }
+                job->run();
+                job->wait();
+                if (job->exception)
+                {
+                    std::rethrow_exception(job->exception);
+                }
+            }
+        private:
+            struct parallel_job
+            {
+                parallel_job(std::size_t count, void* context, void (*call)(void*, std::size_t))
+                    : count(count), context(context), call(call) {}
+                void run() noexcept
+                {
+                    for (auto index = next.fetch_add(1, std::memory_order_relaxed); index < count;
+                        index = next.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        try
+                        {
+                            call(context, index);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(exceptionLock);
+                            if (!exception)
+                            {
+                                exception = std::current_exception();
+                            }
+                        }
+                        if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+                        {
+                            done.notify_all();
+                        }
+                    }
+                }
+                void wait() noexcept
+                {
+                    for (auto completed = done.load(std::memory_order_acquire); completed != count;
+                        completed = done.load(std::memory_order_acquire))
+                    {
+                        done.wait(completed, std::memory_order_acquire);
+                    }
+                }
+                const std::size_t count;
+                void* const context;
+                void (* const call)(void*, std::size_t);
+                std::atomic<std::size_t> next { 0 };
+                std::atomic<std::size_t> done { 0 };
+                std::mutex exceptionLock;
+                std::exception_ptr exception;
+            };
+            void runTasks(std::stop_token stopToken)
+            {
+                while (!stopToken.stop_requested())
+                {
+                    task_t task;
+                    {
+                        std::unique_lock<std::mutex> lock(m_tasksLock);
+                        if (!m_tasksAvailable.wait(lock, stopToken,
+                            [this]() { return !m_tasks.empty(); }))
+                        {
+                            return;
+                        }
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+            std::mutex m_tasksLock;
+            std::condition_variable_any m_tasksAvailable;
+            std::deque<task_t> m_tasks;
+            // Declared last so that the threads are joined before the queue is destroyed.
+            std::vector<std::jthread> m_threads;
+    };
+}
@@ -0,0 +1,94 @@
+/// @file BatchingExecutorTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <latch>
+#include <thread>
+#include <vector>
+#include "BatchingExecutor.h"
+#include "ThreadPool.h"
+
+using namespace jimo::interthread;
+
+// Holds the posted tasks until run is called.
+class ManualExecutor : public Executor
+{
+    public:
+        void post(task_t task) override { m_tasks.push_back(std::move(task)); }
+        std::size_t posted() const noexcept { return m_tasks.size(); }
+        void run()
+        {
+            auto tasks = std::move(m_tasks);
+            m_tasks.clear();
+            for (auto& task : tasks)
+            {
+                task();
+            }
+        }
+    private:
+        std::vector<task_t> m_tasks;
+};
+
+TEST(BatchingExecutorTests, TestPostBatches)
+{
+    ManualExecutor target;
+    std::vector<int> order;
+    BatchingExecutor batch(target);
+    for (int task = 0; task < 10; ++task)
+    {
+        batch.post([&order, task]() { order.push_back(task); });
+    }
+    ASSERT_EQ(1, target.posted());
+    target.run();
+    ASSERT_EQ((std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }), order);
+    batch.post([&order]() { order.push_back(10); });
+    ASSERT_EQ(1, target.posted());
+    target.run();
+    ASSERT_EQ(11, order.size());
+}
+
+TEST(BatchingExecutorTests, TestPostFromTask)
+{
+    ManualExecutor target;
+    std::vector<int> order;
+    BatchingExecutor batch(target);
+    batch.post([&order, &batch]() {
+        order.push_back(0);
+        batch.post([&order]() { order.push_back(1); });
+    });
+    target.run();
+    ASSERT_EQ(0, target.posted());
+    ASSERT_EQ((std::vector<int>{ 0, 1 }), order);
+}
+
+TEST(BatchingExecutorTests, TestStrand)
+{
+    ThreadPool pool(4);
+    std::atomic<int> running = 0;
+    std::atomic<bool> overlapped = false;
+    int count = 0;
+    std::latch producers(4);
+    {
+        BatchingExecutor batch(pool);
+        std::vector<std::jthread> threads;
+        for (int producer = 0; producer < 4; ++producer)
+        {
+            threads.emplace_back([&]() {
+                for (int task = 0; task < 1000; ++task)
+                {
+                    batch.post([&]() {
+                        overlapped = overlapped || ++running > 1;
+                        ++count;
+                        --running;
+                    });
+                }
+                producers.count_down();
+            });
+        }
+        producers.wait();
+    }
+    ASSERT_FALSE(overlapped);
+    ASSERT_EQ(4000, count);
+}
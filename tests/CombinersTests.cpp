@@ -0,0 +1,94 @@
+/// @file CombinersTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include "Combiners.h"
+#include "Delegate.h"
+
+using namespace jimo;
+using namespace jimo::combiners;
+
+TEST(CombinersTests, TestSum)
+{
+    Delegate<int, int> delegate { [](int x) { return x; }, [](int x) { return x * 2; },
+        [](int x) { return x * 3; } };
+    ASSERT_EQ(12, delegate.invokeWith(Sum<int>(), 2));
+    ASSERT_EQ(112, delegate.invokeWith(Sum<int>(100), 2));
+    ASSERT_EQ(6, delegate(2));
+}
+
+TEST(CombinersTests, TestMaximumAndMinimum)
+{
+    Delegate<int, int> delegate { [](int x) { return x; }, [](int x) { return -x; },
+        [](int x) { return x * 2; } };
+    ASSERT_EQ(10, delegate.invokeWith(Maximum<int>(), 5));
+    ASSERT_EQ(-5, delegate.invokeWith(Minimum<int>(), 5));
+    Delegate<int, int> empty;
+    ASSERT_FALSE(empty.invokeWith(Maximum<int>(), 5).has_value());
+}
+
+TEST(CombinersTests, TestAllTrueShortCircuits)
+{
+    int calls = 0;
+    Delegate<bool, int> delegate;
+    delegate += [&calls](int x) { ++calls; return x > 0; };
+    delegate += [&calls](int x) { ++calls; return x > 10; };
+    delegate += [&calls](int x) { ++calls; return x > 100; };
+    ASSERT_FALSE(delegate.invokeWith(AllTrue(), 5));
+    ASSERT_EQ(2, calls);
+    calls = 0;
+    ASSERT_TRUE(delegate.invokeWith(AllTrue(), 500));
+    ASSERT_EQ(3, calls);
+    Delegate<bool, int> empty;
+    ASSERT_TRUE(empty.invokeWith(AllTrue(), 1));
+}
+
+TEST(CombinersTests, TestAnyTrueShortCircuits)
+{
+    int calls = 0;
+    Delegate<bool, int> delegate;
+    delegate += [&calls](int x) { ++calls; return x > 10; };
+    delegate += [&calls](int x) { ++calls; return x > 0; };
+    delegate += [&calls](int x) { ++calls; return x > 100; };
+    ASSERT_TRUE(delegate.invokeWith(AnyTrue(), 5));
+    ASSERT_EQ(2, calls);
+    calls = 0;
+    ASSERT_FALSE(delegate.invokeWith(AnyTrue(), -5));
+    ASSERT_EQ(3, calls);
+}
+
+TEST(CombinersTests, TestFirstNonEmpty)
+{
+    int calls = 0;
+    Delegate<std::optional<int>, int> delegate;
+    delegate += [&calls](int) -> std::optional<int> { ++calls; return std::nullopt; };
+    delegate += [&calls](int x) -> std::optional<int> { ++calls; return x; };
+    delegate += [&calls](int x) -> std::optional<int> { ++calls; return x + 1; };
+    auto result = delegate.invokeWith(FirstNonEmpty<std::optional<int>>(), 7);
+    ASSERT_EQ(7, result);
+    ASSERT_EQ(2, calls);
+}
+
+TEST(CombinersTests, TestCombinerByReference)
+{
+    Delegate<int> delegate { []() { return 1; }, []() { return 2; } };
+    Sum<int> sum;
+    delegate.invokeWith(sum);
+    delegate.invokeWith(sum);
+    ASSERT_EQ(6, sum.result());
+}
+
+TEST(CombinersTests, TestResultOutlivesTemporaryCombiner)
+{
+    Delegate<std::string> delegate {
+        []() { return std::string("a string that is too long for small string storage, "); },
+        []() { return std::string("followed by another"); } };
+    const auto& result = delegate.invokeWith(Sum<std::string>());
+    static_assert(std::is_same_v<std::string,
+        decltype(delegate.invokeWith(Sum<std::string>()))>);
+    ASSERT_EQ("a string that is too long for small string storage, followed by another", result);
+}
@@ -0,0 +1,103 @@
+/// @file ConnectionTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Connection.h"
+#include "Delegate.h"
+
+using namespace jimo;
+
+TEST(ConnectionTests, TestDisconnect)
+{
+    std::vector<int> calls;
+    Delegate<void> delegate;
+    delegate += [&calls]() { calls.push_back(1); };
+    auto connection = delegate.subscribe([&calls]() { calls.push_back(2); });
+    delegate += [&calls]() { calls.push_back(3); };
+    ASSERT_TRUE(connection.connected());
+    ASSERT_EQ(3, delegate.size());
+    delegate();
+    connection.disconnect();
+    ASSERT_FALSE(connection.connected());
+    ASSERT_EQ(2, delegate.size());
+    delegate();
+    ASSERT_EQ((std::vector<int>{ 1, 2, 3, 1, 3 }), calls);
+    connection.disconnect();
+    ASSERT_EQ(2, delegate.size());
+}
+
+TEST(ConnectionTests, TestInsertionOrderAfterReuse)
+{
+    std::vector<int> calls;
+    Delegate<void> delegate;
+    auto first = delegate.subscribe([&calls]() { calls.push_back(1); });
+    auto second = delegate.subscribe([&calls]() { calls.push_back(2); });
+    first.disconnect();
+    auto third = delegate.subscribe([&calls]() { calls.push_back(3); });
+    delegate();
+    ASSERT_EQ((std::vector<int>{ 2, 3 }), calls);
+    ASSERT_FALSE(first.connected());
+    ASSERT_TRUE(second.connected());
+    ASSERT_TRUE(third.connected());
+}
+
+TEST(ConnectionTests, TestDisconnectLastFunction)
+{
+    Delegate<int> delegate([]() { return 1; });
+    auto connection = delegate.subscribe([]() { return 2; });
+    ASSERT_EQ(2, delegate());
+    connection.disconnect();
+    ASSERT_EQ(1, delegate());
+    Delegate<int> delegate2;
+    auto connection2 = delegate2.subscribe([]() { return 2; });
+    connection2.disconnect();
+    ASSERT_TRUE(delegate2.empty());
+    ASSERT_EQ(0, delegate2());
+}
+
+int three() { return 3; }
+
+TEST(ConnectionTests, TestRemovedFunctionIsNotConnected)
+{
+    Delegate<int> delegate;
+    auto connection = delegate.subscribe(three);
+    delegate -= three;
+    ASSERT_FALSE(connection.connected());
+    auto connection2 = delegate.subscribe(three);
+    delegate.clear();
+    ASSERT_FALSE(connection2.connected());
+}
+
+TEST(ConnectionTests, TestDelegateDestroyed)
+{
+    Connection connection;
+    {
+        Delegate<void> delegate;
+        connection = delegate.subscribe([]() {});
+        ASSERT_TRUE(connection.connected());
+    }
+    ASSERT_FALSE(connection.connected());
+    connection.disconnect();
+}
+
+TEST(ConnectionTests, TestScopedConnection)
+{
+    int calls = 0;
+    Delegate<void> delegate;
+    {
+        ScopedConnection scoped = delegate.subscribe([&calls]() { ++calls; });
+        delegate();
+        ScopedConnection moved(std::move(scoped));
+        ASSERT_FALSE(scoped.connected());
+        ASSERT_TRUE(moved.connected());
+        delegate();
+    }
+    delegate();
+    ASSERT_EQ(2, calls);
+    ASSERT_TRUE(delegate.empty());
+    ScopedConnection released = delegate.subscribe([&calls]() { ++calls; });
+    auto connection = released.release();
+    ASSERT_TRUE(connection.connected());
+}
@@ -5,6 +5,11 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <tuple>
+#include <vector>
 #include "Delegate.h"
 #include "EventArgs.h"
 
@@ -352,4 +357,472 @@ TEST(DelegateTests, testFunctionsDelegatesInitializerListConstructor)
     Delegate<int, int> delegate { {func2, addThree, [](int x){int y = x; return y;}},
         {data, &Data::setThree}};
     ASSERT_EQ(4, delegate.size());
-}
\ No newline at end of file
+}
+TEST(DelegateTests, TestAddDuringInvoke)
+{
+    int calls = 0;
+    Delegate<void> delegate;
+    delegate += [&delegate, &calls]() {
+        ++calls;
+        delegate += [&calls]() { calls += 10; };
+    };
+    delegate();
+    ASSERT_EQ(1, calls);
+    ASSERT_EQ(2, delegate.size());
+    delegate();
+    ASSERT_EQ(12, calls);
+    ASSERT_EQ(3, delegate.size());
+}
+
+TEST(DelegateTests, TestConcurrentAddAndInvoke)
+{
+    std::atomic<int> calls = 0;
+    Delegate<void> delegate([&calls]() { ++calls; });
+    std::thread writer([&delegate, &calls]() {
+        for (int i = 0; i < 1000; ++i)
+        {
+            delegate += [&calls]() { ++calls; };
+        }
+    });
+    for (int i = 0; i < 1000; ++i)
+    {
+        delegate();
+    }
+    writer.join();
+    ASSERT_EQ(1001, delegate.size());
+    ASSERT_GE(calls.load(), 1000);
+}
+
+TEST(DelegateTests, TestMethodDelegateManyParameters)
+{
+    class Object
+    {
+        public:
+            int addSeven(int a, int b, int c, int d, int e, int f, int g) const noexcept
+            {
+                return a + b + c + d + e + f + g;
+            }
+    };
+    Object object;
+    Delegate<int, int, int, int, int, int, int, int> delegate(object, &Object::addSeven);
+    ASSERT_EQ(28, delegate(1, 2, 3, 4, 5, 6, 7));
+}
+
+TEST(DelegateTests, TestMinusEqualsMethodOfOneObject)
+{
+    class Object
+    {
+        public:
+            Object(int value) : m_value(value) {}
+            int add(int x) { return x + m_value; }
+            int subtract(int x) { return x - m_value; }
+        private:
+            int m_value;
+    };
+    Object one(1);
+    Object two(2);
+    Delegate<int, int> delegate { { one, &Object::add }, { two, &Object::add },
+        { one, &Object::subtract } };
+    using Handler = Delegate<int, int>;
+    ASSERT_TRUE(Handler(one, &Object::add) == Handler(one, &Object::add));
+    ASSERT_FALSE(Handler(one, &Object::add) == Handler(two, &Object::add));
+    ASSERT_FALSE(Handler(one, &Object::add) == Handler(one, &Object::subtract));
+    delegate -= { one, &Object::add };
+    ASSERT_EQ(2, delegate.size());
+    delegate -= { one, &Object::subtract };
+    ASSERT_EQ(1, delegate.size());
+    ASSERT_EQ(7, delegate(5));
+}
+
+TEST(DelegateTests, TestInvokeParallel)
+{
+    interthread::ThreadPool pool(2);
+    std::atomic<int> total = 0;
+    Delegate<void, int> delegate;
+    for (int i = 0; i < 10; ++i)
+    {
+        delegate += [&total](int x) { total += x; };
+    }
+    auto connection = delegate.subscribe([&total](int x) { total += 100 * x; });
+    connection.disconnect();
+    delegate.invokeParallel(pool, 3);
+    ASSERT_EQ(30, total);
+}
+
+TEST(DelegateTests, TestMoveOnlyArgument)
+{
+    Delegate<int, std::unique_ptr<int>> delegate;
+    int seen = 0;
+    delegate += [&seen](const std::unique_ptr<int>& value) { seen = *value; return 0; };
+    delegate += [](std::unique_ptr<int> value) { return *value * 2; };
+    ASSERT_EQ(42, delegate(std::make_unique<int>(21)));
+    ASSERT_EQ(21, seen);
+    auto value = std::make_unique<int>(5);
+    ASSERT_EQ(10, delegate.invoke(std::move(value)));
+    ASSERT_EQ(5, seen);
+}
+
+struct Counted
+{
+    Counted() = default;
+    Counted(const Counted&) { ++copies; }
+    Counted(Counted&&) noexcept {}
+    static inline int copies = 0;
+};
+
+TEST(DelegateTests, TestArgumentCopies)
+{
+    Delegate<void, Counted> byReference;
+    Delegate<void, Counted> byValue;
+    for (int i = 0; i < 3; ++i)
+    {
+        byReference += [](const Counted&) {};
+        byValue += [](Counted) {};
+    }
+    Counted::copies = 0;
+    byReference(Counted());
+    // Each function but the last receives its own copy.
+    ASSERT_EQ(2, Counted::copies);
+    Counted::copies = 0;
+    byValue(Counted());
+    ASSERT_EQ(2, Counted::copies);
+    Counted::copies = 0;
+    Counted counted;
+    byValue.invoke(counted);
+    ASSERT_EQ(3, Counted::copies);
+}
+
+TEST(DelegateTests, TestLargeArgumentNotCopied)
+{
+    struct Large
+    {
+        int values[256];
+    };
+    Delegate<const int*, Large> delegate;
+    const int* first = nullptr;
+    delegate += [&first](const Large& large) { first = large.values; return large.values; };
+    delegate += [](const Large& large) { return large.values; };
+    Large large {};
+    auto last = delegate(large);
+    // Both functions saw the same object, the Delegate's parameter.
+    ASSERT_EQ(first, last);
+}
+
+TEST(DelegateTests, TestInvokeBatch)
+{
+    std::vector<int> calls;
+    Delegate<void, int> delegate;
+    delegate += [&calls](int x) { calls.push_back(x); };
+    delegate += [&calls](int x) { calls.push_back(10 * x); };
+    auto connection = delegate.subscribe([&calls](int x) { calls.push_back(100 * x); });
+    connection.disconnect();
+    std::vector<std::tuple<int>> batch { { 1 }, { 2 }, { 3 } };
+    delegate.invokeBatch(batch);
+    ASSERT_EQ((std::vector<int> { 1, 10, 2, 20, 3, 30 }), calls);
+    calls.clear();
+    delegate.invokeBatch(batch, BatchOrder::HandlerMajor);
+    ASSERT_EQ((std::vector<int> { 1, 2, 3, 10, 20, 30 }), calls);
+    calls.clear();
+    Delegate<void, int>().invokeBatch(batch);
+    delegate.invokeBatch({});
+    ASSERT_TRUE(calls.empty());
+}
+
+TEST(DelegateTests, TestTrackedSubscription)
+{
+    class Accumulator
+    {
+        public:
+            int add(int x) { m_total += x; return m_total; }
+            int total(int) const { return m_total; }
+        private:
+            int m_total = 0;
+    };
+    auto accumulator = std::make_shared<Accumulator>();
+    std::shared_ptr<const Accumulator> constAccumulator = accumulator;
+    Delegate<int, int> delegate;
+    int calls = 0;
+    auto addConnection = delegate.subscribe(accumulator, &Accumulator::add);
+    auto lambdaConnection = delegate.subscribe([&calls](int) { return ++calls; }, accumulator);
+    auto totalConnection = delegate.subscribe(constAccumulator, &Accumulator::total);
+    delegate += func2;
+    ASSERT_EQ(4, delegate.size());
+    ASSERT_EQ(5, delegate(3));
+    ASSERT_EQ(3, accumulator->add(0));
+    ASSERT_EQ(1, calls);
+    accumulator.reset();
+    constAccumulator.reset();
+    ASSERT_EQ(1, delegate.size());
+    ASSERT_EQ(6, delegate(4));
+    ASSERT_EQ(1, calls);
+    // The invocation removed the functions whose target was destroyed.
+    ASSERT_FALSE(addConnection.connected());
+    ASSERT_FALSE(lambdaConnection.connected());
+    ASSERT_FALSE(totalConnection.connected());
+    ASSERT_EQ(1, delegate.size());
+}
+
+TEST(DelegateTests, TestTrackedSubscriptionCopied)
+{
+    auto target = std::make_shared<int>(0);
+    Delegate<void, int> delegate;
+    delegate.subscribe([target = std::weak_ptr<int>(target)](int x) { *target.lock() += x; }, target);
+    Delegate<void, int> other;
+    other += delegate;
+    other(2);
+    ASSERT_EQ(2, *target);
+    target.reset();
+    other(3);
+    delegate(4);
+    ASSERT_TRUE(other.empty());
+    ASSERT_TRUE(delegate.empty());
+}
+
+TEST(DelegateTests, TestTrackedSubscriptionSizeAfterExpiry)
+{
+    auto target = std::make_shared<int>(0);
+    Delegate<void, int> delegate;
+    delegate.subscribe([](int) {}, target);
+    Delegate<void, int> copied(delegate);
+    Delegate<void, int> combined;
+    combined += delegate;
+    ASSERT_EQ(1, copied.size());
+    ASSERT_EQ(1, combined.size());
+    target.reset();
+    ASSERT_EQ(0, copied.size());
+    ASSERT_TRUE(copied.empty());
+    ASSERT_EQ(0, combined.size());
+    ASSERT_TRUE(combined.empty());
+    ASSERT_EQ(0, delegate.size());
+}
+
+TEST(DelegateTests, TestPriority)
+{
+    std::vector<int> calls;
+    Delegate<void> delegate;
+    delegate += [&calls]() { calls.push_back(1); };
+    delegate += { [&calls]() { calls.push_back(2); }, -1 };
+    delegate += { [&calls]() { calls.push_back(3); }, 5 };
+    delegate += [&calls]() { calls.push_back(4); };
+    auto connection = delegate.subscribe({ [&calls]() { calls.push_back(5); }, 5 });
+    delegate += { [&calls]() { calls.push_back(6); }, 10 };
+    delegate();
+    ASSERT_EQ((std::vector<int> { 6, 3, 5, 1, 4, 2 }), calls);
+    calls.clear();
+    connection.disconnect();
+    Delegate<void> other { [&calls]() { calls.push_back(7); } };
+    other += delegate;
+    other();
+    ASSERT_EQ((std::vector<int> { 6, 3, 7, 1, 4, 2 }), calls);
+}
+
+// Exposes the function list, so that tests can check when it is shared.
+class InspectableDelegate : public Delegate<int, int>
+{
+    public:
+        using Delegate<int, int>::Delegate;
+        using Delegate<int, int>::functions;
+};
+
+TEST(DelegateTests, TestCopySharesFunctions)
+{
+    InspectableDelegate delegate { func2, func3 };
+    InspectableDelegate copy(delegate);
+    ASSERT_EQ(delegate.functions(), copy.functions());
+    InspectableDelegate assigned;
+    assigned = delegate;
+    ASSERT_EQ(delegate.functions(), assigned.functions());
+    copy += func2;
+    ASSERT_NE(delegate.functions(), copy.functions());
+    ASSERT_EQ(2, delegate.size());
+    ASSERT_EQ(3, copy.size());
+}
+
+TEST(DelegateTests, TestCopyKeepsSubscribedFunctions)
+{
+    Delegate<int, int> delegate;
+    auto connection2 = delegate.subscribe(func2);
+    auto connection3 = delegate.subscribe(func3);
+    Delegate<int, int> copy(delegate);
+    Delegate<int, int> assigned;
+    assigned = delegate;
+    connection2.disconnect();
+    ASSERT_EQ(1, delegate.size());
+    ASSERT_EQ(2, copy.size());
+    ASSERT_EQ(2, assigned.size());
+    delegate.clear();
+    ASSERT_FALSE(connection3.connected());
+    ASSERT_EQ(2, copy.size());
+    ASSERT_EQ(4, copy(1));
+    auto copyConnection = copy.subscribe(func2);
+    copy -= func3;
+    ASSERT_EQ(2, copy.size());
+    ASSERT_EQ(2, assigned.size());
+    ASSERT_TRUE(delegate.empty());
+    copyConnection.disconnect();
+    ASSERT_EQ(1, copy.size());
+    ASSERT_EQ(2, assigned.size());
+}
+
+TEST(DelegateTests, TestMoveTakesFunctions)
+{
+    InspectableDelegate delegate { func2, func3 };
+    auto functions = delegate.functions();
+    InspectableDelegate moved(std::move(delegate));
+    ASSERT_EQ(functions, moved.functions());
+    ASSERT_EQ(nullptr, delegate.functions());
+    InspectableDelegate assigned { func2 };
+    assigned = std::move(moved);
+    ASSERT_EQ(functions, assigned.functions());
+    ASSERT_EQ(nullptr, moved.functions());
+    ASSERT_EQ(4, assigned(1));
+    delegate += func2;
+    ASSERT_EQ(3, delegate(1));
+    assigned = std::move(moved);
+    ASSERT_TRUE(assigned.empty());
+}
+
+TEST(DelegateTests, TestTransaction)
+{
+    std::vector<int> calls;
+    auto one = [&calls]() { calls.push_back(1); };
+    auto two = [&calls]() { calls.push_back(2); };
+    Delegate<void> delegate { one };
+    auto transaction = delegate.startTransaction();
+    transaction += two;
+    transaction += { [&calls]() { calls.push_back(3); }, 1 };
+    transaction -= one;
+    ASSERT_EQ(3, transaction.size());
+    ASSERT_EQ(1, delegate.size());
+    transaction.commit();
+    ASSERT_EQ(0, transaction.size());
+    delegate();
+    ASSERT_EQ((std::vector<int> { 3, 2 }), calls);
+    transaction.clear();
+    transaction += one;
+    transaction.commit();
+    calls.clear();
+    delegate();
+    ASSERT_EQ((std::vector<int> { 1 }), calls);
+    {
+        auto discarded = delegate.startTransaction();
+        discarded.clear();
+    }
+    ASSERT_EQ(1, delegate.size());
+}
+
+TEST(DelegateTests, TestTransactionIsAtomic)
+{
+    constexpr int count = 50;
+    Delegate<void, int&, int&> delegate;
+    for (int i = 0; i < count; ++i)
+    {
+        delegate += [](int& before, int&) { ++before; };
+    }
+    std::atomic<bool> committed = false;
+    std::jthread writer([&delegate, &committed]() {
+        auto transaction = delegate.startTransaction();
+        transaction.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            transaction += [](int&, int& after) { ++after; };
+        }
+        transaction.commit();
+        committed = true;
+    });
+    bool done = false;
+    while (!done)
+    {
+        done = committed;
+        int before = 0;
+        int after = 0;
+        delegate(before, after);
+        ASSERT_TRUE((before == count && after == 0) || (before == 0 && after == count));
+    }
+    int before = 0;
+    int after = 0;
+    delegate(before, after);
+    ASSERT_EQ(0, before);
+    ASSERT_EQ(count, after);
+}
+
+TEST(DelegateTests, TestContains)
+{
+    class Object
+    {
+        public:
+            int add(int x) { return x + 1; }
+            int subtract(int x) { return x - 1; }
+    };
+    Object one;
+    Object two;
+    auto lambda = [](int x) { return x; };
+    Delegate<int, int> delegate { func2 };
+    delegate += { one, &Object::add };
+    delegate += lambda;
+    ASSERT_TRUE(delegate.contains(func2));
+    ASSERT_FALSE(delegate.contains(func3));
+    ASSERT_TRUE(delegate.contains(Delegate<int, int>::function_t(lambda)));
+    using Binding = MethodBinding<int, Object, decltype(&Object::add)>;
+    ASSERT_TRUE(delegate.contains(Binding { &one, &Object::add }));
+    ASSERT_FALSE(delegate.contains(Binding { &one, &Object::subtract }));
+    ASSERT_FALSE(delegate.contains(Binding { &two, &Object::add }));
+    auto connection = delegate.subscribe(func3);
+    ASSERT_TRUE(delegate.contains(func3));
+    connection.disconnect();
+    ASSERT_FALSE(delegate.contains(func3));
+    Delegate<int, int> empty;
+    ASSERT_FALSE(empty.contains(func2));
+}
+
+TEST(DelegateTests, TestContainsManyFunctions)
+{
+    class Counter
+    {
+        public:
+            int add(int x) { return x + 1; }
+    };
+    using Binding = MethodBinding<int, Counter, decltype(&Counter::add)>;
+    std::vector<Counter> counters(1000);
+    Delegate<int, int> delegate;
+    auto transaction = delegate.startTransaction();
+    for (auto& counter : counters)
+    {
+        transaction += Binding { &counter, &Counter::add };
+    }
+    transaction.commit();
+    ASSERT_EQ(1000, delegate.size());
+    for (auto& counter : counters)
+    {
+        ASSERT_TRUE(delegate.contains(Binding { &counter, &Counter::add }));
+    }
+    Counter other;
+    ASSERT_FALSE(delegate.contains(Binding { &other, &Counter::add }));
+    delegate -= { counters[500], &Counter::add };
+    ASSERT_EQ(999, delegate.size());
+    ASSERT_FALSE(delegate.contains(Binding { &counters[500], &Counter::add }));
+    ASSERT_TRUE(delegate.contains(Binding { &counters[501], &Counter::add }));
+    Delegate<int, int> removed { { counters[0], &Counter::add }, { counters[999], &Counter::add } };
+    delegate -= removed;
+    ASSERT_EQ(997, delegate.size());
+    ASSERT_FALSE(delegate.contains(Binding { &counters[999], &Counter::add }));
+}
+
+TEST(DelegateTests, TestContainsWithUnhashableFunctions)
+{
+    InspectableDelegate delegate;
+    auto transaction = delegate.startTransaction();
+    for (int lambda = 0; lambda < 1000; ++lambda)
+    {
+        transaction += [lambda](int x) { return x + lambda; };
+    }
+    transaction += func3;
+    transaction.commit();
+    ASSERT_TRUE(delegate.contains(func3));
+    // Only func3 can be hashed, so the lambdas are not in the index.
+    auto index = delegate.functions()->index;
+    ASSERT_EQ(1, std::ranges::count_if(index, [](std::uint32_t entry) { return entry != 0; }));
+    delegate -= func3;
+    ASSERT_FALSE(delegate.contains(func3));
+    ASSERT_EQ(1000, delegate.size());
+}
@@ -0,0 +1,87 @@
+/// @file DispatchQueueTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <latch>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "DispatchQueue.h"
+
+using namespace jimo::interthread;
+
+TEST(DispatchQueueTests, TestConstructor)
+{
+    DispatchQueue queue(1000, 10);
+    ASSERT_EQ(1024, queue.capacity());
+    ASSERT_EQ(10, queue.maxBatch());
+    ASSERT_THROW(DispatchQueue(0), std::invalid_argument);
+    ASSERT_THROW(DispatchQueue(16, 0), std::invalid_argument);
+}
+
+TEST(DispatchQueueTests, TestPostRunsInOrder)
+{
+    std::vector<int> order;
+    std::thread::id dispatcher;
+    {
+        DispatchQueue queue(8, 3);
+        for (int task = 0; task < 100; ++task)
+        {
+            queue.post([&order, &dispatcher, task]() {
+                order.push_back(task);
+                dispatcher = std::this_thread::get_id();
+            });
+        }
+    }
+    ASSERT_EQ(100, order.size());
+    for (int task = 0; task < 100; ++task)
+    {
+        ASSERT_EQ(task, order[task]);
+    }
+    ASSERT_NE(std::this_thread::get_id(), dispatcher);
+}
+
+TEST(DispatchQueueTests, TestManyProducers)
+{
+    std::atomic<int> count = 0;
+    {
+        DispatchQueue queue(64);
+        std::vector<std::jthread> producers;
+        for (int producer = 0; producer < 4; ++producer)
+        {
+            producers.emplace_back([&queue, &count]() {
+                for (int task = 0; task < 1000; ++task)
+                {
+                    queue.post([&count]() { ++count; });
+                }
+            });
+        }
+    }
+    ASSERT_EQ(4000, count);
+}
+
+TEST(DispatchQueueTests, TestTryPostFull)
+{
+    std::latch release(1);
+    std::latch started(1);
+    int count = 0;
+    {
+        DispatchQueue queue(2);
+        queue.post([&started, &release]() {
+            started.count_down();
+            release.wait();
+        });
+        started.wait();
+        DispatchQueue::task_t task = [&count]() { ++count; };
+        ASSERT_TRUE(queue.tryPost(task));
+        task = [&count]() { ++count; };
+        ASSERT_TRUE(queue.tryPost(task));
+        task = [&count]() { ++count; };
+        ASSERT_FALSE(queue.tryPost(task));
+        ASSERT_TRUE(static_cast<bool>(task));
+        release.count_down();
+    }
+    ASSERT_EQ(2, count);
+}
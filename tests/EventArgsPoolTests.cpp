@@ -0,0 +1,174 @@
+/// @file EventArgsPoolTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "Event.h"
+#include "EventArgsPool.h"
+
+using namespace jimo;
+
+// Count the allocations made by each thread, so that the tests can check that publishing
+// allocates nothing.
+thread_local std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (auto memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+class PooledEventArgs : public EventArgs
+{
+    public:
+        PooledEventArgs(int number) : m_number(number) {}
+        int number() const noexcept { return m_number; }
+    private:
+        int m_number;
+};
+
+class PoolSender : public Object
+{
+    public:
+        Event<PoolSender, PooledEventArgs> published;
+};
+
+using Pool = EventArgsPool<PooledEventArgs>;
+
+TEST(EventArgsPoolTests, TestMakeReusesMemory)
+{
+    Pool::trim();
+    auto first = Pool::make(1);
+    ASSERT_EQ(1, first->number());
+    auto address = first.get();
+    first.reset();
+    ASSERT_EQ(1, Pool::pooled());
+    auto second = Pool::make(2);
+    ASSERT_EQ(address, second.get());
+    ASSERT_EQ(2, second->number());
+    ASSERT_EQ(0, Pool::pooled());
+}
+
+TEST(EventArgsPoolTests, TestSteadyStatePublishingAllocatesNothing)
+{
+    PoolSender sender;
+    int total = 0;
+    sender.published += [&total](PoolSender&, PooledEventArgs& e) { total += e.number(); };
+    Pool::reserve(4);
+    auto before = allocations;
+    for (int publication = 0; publication < 1000; ++publication)
+    {
+        auto e = Pool::make(publication);
+        sender.published(sender, *e);
+    }
+    ASSERT_EQ(before, allocations);
+    ASSERT_EQ(999 * 1000 / 2, total);
+}
+
+TEST(EventArgsPoolTests, TestMaxPooled)
+{
+    Pool::trim();
+    ASSERT_EQ(Pool::defaultMaxPooled, Pool::maxPooled());
+    Pool::maxPooled(2);
+    Pool::reserve(5);
+    ASSERT_EQ(2, Pool::pooled());
+    {
+        auto first = Pool::make(1);
+        auto second = Pool::make(2);
+        auto third = Pool::make(3);
+        ASSERT_EQ(0, Pool::pooled());
+    }
+    ASSERT_EQ(2, Pool::pooled());
+    Pool::maxPooled(1);
+    ASSERT_EQ(1, Pool::pooled());
+    Pool::maxPooled(Pool::defaultMaxPooled);
+}
+
+TEST(EventArgsPoolTests, TestPoolsArePerThread)
+{
+    Pool::trim();
+    Pool::reserve(3);
+    std::size_t otherThread = 0;
+    std::thread([&otherThread]() { otherThread = Pool::pooled(); }).join();
+    ASSERT_EQ(0, otherThread);
+    ASSERT_EQ(3, Pool::pooled());
+}
+
+TEST(EventArgsPoolTests, TestMemoryReturnsToTheMakingThread)
+{
+    PoolSender sender;
+    int total = 0;
+    sender.published += [&total](PoolSender&, PooledEventArgs& e) { total += e.number(); };
+    std::mutex lock;
+    std::condition_variable changed;
+    Pool::pointer handedOff;
+    bool done = false;
+    std::thread consumer([&]()
+        {
+            std::unique_lock guard(lock);
+            while (true)
+            {
+                changed.wait(guard, [&]() { return handedOff || done; });
+                if (!handedOff)
+                {
+                    return;
+                }
+                sender.published(sender, *handedOff);
+                handedOff.reset();
+                changed.notify_all();
+            }
+        });
+    Pool::trim();
+    auto before = allocations;
+    for (int publication = 0; publication < 1000; ++publication)
+    {
+        auto e = Pool::make(publication);
+        std::unique_lock guard(lock);
+        handedOff = std::move(e);
+        changed.notify_all();
+        changed.wait(guard, [&]() { return !handedOff; });
+    }
+    auto made = allocations - before;
+    {
+        std::lock_guard guard(lock);
+        done = true;
+    }
+    changed.notify_all();
+    consumer.join();
+    ASSERT_EQ(1, made);
+    ASSERT_EQ(999 * 1000 / 2, total);
+    ASSERT_EQ(1, Pool::pooled());
+}
+
+TEST(EventArgsPoolTests, TestArgsOutliveTheMakingThread)
+{
+    Pool::trim();
+    Pool::pointer e;
+    std::thread([&e]()
+        {
+            Pool::reserve(3);
+            e = Pool::make(7);
+        }).join();
+    ASSERT_EQ(7, e->number());
+    e.reset();
+    ASSERT_EQ(0, Pool::pooled());
+}
@@ -0,0 +1,77 @@
+/// @file EventBusTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "EventBus.h"
+
+using namespace jimo;
+
+class BusSender : public Object
+{
+};
+
+TEST(EventBusTests, TestPublishCallsOnlyTopic)
+{
+    EventBus<int, BusSender, EventArgs> bus;
+    std::vector<int> calls;
+    bus.subscribe(1, [&calls](BusSender&, EventArgs&) { calls.push_back(1); });
+    bus.subscribe(2, [&calls](BusSender&, EventArgs&) { calls.push_back(2); });
+    bus.subscribe(2, [&calls](BusSender&, EventArgs&) { calls.push_back(20); });
+    ASSERT_EQ(2, bus.topics());
+    ASSERT_EQ(2, bus.size(2));
+    ASSERT_EQ(0, bus.size(3));
+    BusSender sender;
+    EventArgs e;
+    bus.publish(2, sender, e);
+    ASSERT_EQ((std::vector<int>{ 2, 20 }), calls);
+    calls.clear();
+    bus.publish(3, sender, e);
+    ASSERT_TRUE(calls.empty());
+    ASSERT_EQ(2, bus.topics());
+}
+
+void countCall(BusSender&, EventArgs&);
+int busCalls = 0;
+void countCall(BusSender&, EventArgs&)
+{
+    ++busCalls;
+}
+
+TEST(EventBusTests, TestUnsubscribe)
+{
+    EventBus<std::string, BusSender, EventArgs> bus;
+    busCalls = 0;
+    bus.subscribe("a", countCall);
+    auto connection = bus.subscribe("b", countCall);
+    BusSender sender;
+    EventArgs e;
+    bus.publish("a", sender, e);
+    bus.publish("b", sender, e);
+    ASSERT_EQ(2, busCalls);
+    bus.unsubscribe("a", countCall);
+    connection.disconnect();
+    bus.publish("a", sender, e);
+    bus.publish("b", sender, e);
+    ASSERT_EQ(2, busCalls);
+    bus.unsubscribe("c", countCall);
+    ASSERT_EQ(2, bus.topics());
+}
+
+TEST(EventBusTests, TestTopicAndClear)
+{
+    EventBus<int, BusSender, EventArgs> bus;
+    int calls = 0;
+    bus.topic(7) += [&calls](BusSender&, EventArgs&) { ++calls; };
+    ASSERT_EQ(&bus.topic(7), &bus.topic(7));
+    BusSender sender;
+    EventArgs e;
+    bus.publish(7, sender, e);
+    ASSERT_EQ(1, calls);
+    bus.clear();
+    bus.publish(7, sender, e);
+    ASSERT_EQ(1, calls);
+    ASSERT_EQ(0, bus.size(7));
+}
@@ -0,0 +1,76 @@
+/// @file EventDispatcherTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "EventDispatcher.h"
+
+using namespace jimo;
+
+class SavedEventArgs : public EventArgs
+{
+};
+
+class ClosedEventArgs : public EventArgs
+{
+    public:
+        ClosedEventArgs(int code) : m_code(code) {}
+        int code() const noexcept { return m_code; }
+    private:
+        int m_code;
+};
+
+class Document : public Object
+{
+};
+
+TEST(EventDispatcherTests, TestPublishRoutesByType)
+{
+    EventDispatcher<> dispatcher;
+    std::vector<int> calls;
+    dispatcher.subscribe<SavedEventArgs>([&calls](Object&, SavedEventArgs&) { calls.push_back(1); });
+    dispatcher.subscribe<ClosedEventArgs>([&calls](Object&, ClosedEventArgs& e) {
+        calls.push_back(e.code());
+    });
+    ASSERT_EQ(1, dispatcher.size<SavedEventArgs>());
+    ASSERT_EQ(0, dispatcher.size<EventArgs>());
+    Document document;
+    ClosedEventArgs closed(7);
+    dispatcher.publish(document, closed);
+    SavedEventArgs saved;
+    dispatcher.publish(document, saved);
+    EventArgs base;
+    dispatcher.publish(document, base);
+    ASSERT_EQ((std::vector<int>{ 7, 1 }), calls);
+}
+
+TEST(EventDispatcherTests, TestUnsubscribe)
+{
+    EventDispatcher<Document> dispatcher;
+    int calls = 0;
+    auto connection = dispatcher.subscribe<SavedEventArgs>([&calls](Document&, SavedEventArgs&) {
+        ++calls;
+    });
+    Document document;
+    SavedEventArgs saved;
+    dispatcher.publish(document, saved);
+    connection.disconnect();
+    dispatcher.publish(document, saved);
+    ASSERT_EQ(1, calls);
+    ASSERT_EQ(&dispatcher.event<SavedEventArgs>(), &dispatcher.event<SavedEventArgs>());
+}
+
+TEST(EventDispatcherTests, TestDispatchersAreIndependent)
+{
+    EventDispatcher<> first;
+    EventDispatcher<> second;
+    int calls = 0;
+    first.event<ClosedEventArgs>() += [&calls](Object&, ClosedEventArgs&) { ++calls; };
+    Document document;
+    ClosedEventArgs closed(1);
+    second.publish(document, closed);
+    ASSERT_EQ(0, calls);
+    first.publish(document, closed);
+    ASSERT_EQ(1, calls);
+}
@@ -0,0 +1,176 @@
+/// @file EventRecorderTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "EventRecorder.h"
+
+using namespace jimo;
+using namespace jimo::recording;
+
+class ValueEventArgs : public EventArgs
+{
+    public:
+        ValueEventArgs(int value = 0) : m_value(value) {}
+        int value() const noexcept { return m_value; }
+    private:
+        int m_value;
+};
+
+struct ValueSerializer
+{
+    std::size_t size(const ValueEventArgs&) const noexcept { return sizeof(int); }
+    void write(const ValueEventArgs& e, std::span<std::byte> out) const noexcept
+    {
+        auto value = e.value();
+        std::memcpy(out.data(), &value, sizeof(value));
+    }
+    ValueEventArgs read(std::span<const std::byte> in) const
+    {
+        int value;
+        std::memcpy(&value, in.data(), sizeof(value));
+        return ValueEventArgs(value);
+    }
+};
+
+class Recorded : public Object
+{
+    public:
+        Event<Recorded, ValueEventArgs> valueChanged;
+        Event<Recorded, EventArgs> reset;
+};
+
+TEST(EventRecorderTests, TestRecordAndReplay)
+{
+    std::vector<std::uint64_t> memory(128);
+    auto log = std::as_writable_bytes(std::span(memory));
+    Recorded source;
+    {
+        EventRecorder<> recorder(log);
+        recorder.record(source.valueChanged, 1, ValueSerializer());
+        recorder.record(source.reset, 2);
+        for (int value : { 5, 6 })
+        {
+            ValueEventArgs e(value);
+            source.valueChanged(source, e);
+        }
+        EventArgs e;
+        source.reset(source, e);
+        ASSERT_EQ(2 * EventLog::recordSize(sizeof(int)) + EventLog::recordSize(0), recorder.used());
+        ASSERT_EQ(0, recorder.dropped());
+    }
+    ASSERT_TRUE(source.valueChanged.empty());
+
+    Recorded target;
+    std::vector<int> replayed;
+    target.valueChanged += [&replayed](Recorded&, ValueEventArgs& e) { replayed.push_back(e.value()); };
+    target.reset += [&replayed](Recorded&, EventArgs&) { replayed.push_back(0); };
+    EventReplayer<> replayer(log);
+    ASSERT_EQ(3, replayer.size());
+    replayer.add(1, target.valueChanged, target, ValueSerializer());
+    ASSERT_EQ(2, replayer.replay(ReplaySpeed::Maximum));
+    ASSERT_EQ((std::vector<int>{ 5, 6 }), replayed);
+    replayer.add(2, target.reset, target);
+    ASSERT_EQ(3, replayer.replay());
+    ASSERT_EQ((std::vector<int>{ 5, 6, 5, 6, 0 }), replayed);
+}
+
+TEST(EventRecorderTests, TestRecordsBeforeHalt)
+{
+    std::vector<std::uint64_t> memory(16);
+    Recorded source;
+    source.reset += [](Recorded&, EventArgs& e) { e.halt(true); };
+    EventRecorder<> recorder(std::as_writable_bytes(std::span(memory)));
+    recorder.record(source.reset, 2);
+    EventArgs e;
+    source.reset(source, e);
+    ASSERT_EQ(EventLog::recordSize(0), recorder.used());
+}
+
+TEST(EventRecorderTests, TestFullLogDrops)
+{
+    std::vector<std::uint64_t> memory((sizeof(EventLog::header) + EventLog::recordSize(0)) / 8);
+    Recorded source;
+    EventRecorder<> recorder(std::as_writable_bytes(std::span(memory)));
+    recorder.record(source.reset, 2);
+    EventArgs e;
+    source.reset(source, e);
+    source.reset(source, e);
+    ASSERT_EQ(1, recorder.dropped());
+    EventReplayer<> replayer(std::as_bytes(std::span(memory)));
+    ASSERT_EQ(1, replayer.size());
+}
+
+TEST(EventRecorderTests, TestUnwrittenRecordIsSkipped)
+{
+    std::vector<std::uint64_t> memory(64);
+    auto log = std::as_writable_bytes(std::span(memory));
+    EventRecorder<> recorder(log);
+    ValueSerializer serializer;
+    ASSERT_TRUE(recorder.append(1, ValueEventArgs(5), serializer));
+    // Reserve space for a record without writing it, as if the recording process had ended
+    // between the two steps.
+    auto header = reinterpret_cast<EventLog::header*>(log.data());
+    header->used += EventLog::recordSize(12);
+    ASSERT_TRUE(recorder.append(1, ValueEventArgs(6), serializer));
+
+    Recorded target;
+    std::vector<int> replayed;
+    target.valueChanged += [&replayed](Recorded&, ValueEventArgs& e) { replayed.push_back(e.value()); };
+    EventReplayer<> replayer(log);
+    replayer.add(1, target.valueChanged, target, ValueSerializer());
+    ASSERT_EQ(2, replayer.size());
+    ASSERT_EQ(2, replayer.replay(ReplaySpeed::Maximum));
+    ASSERT_EQ((std::vector<int>{ 5, 6 }), replayed);
+}
+
+TEST(EventRecorderTests, TestEventIdZeroIsReserved)
+{
+    std::vector<std::uint64_t> memory(16);
+    Recorded source;
+    EventRecorder<> recorder(std::as_writable_bytes(std::span(memory)));
+    ASSERT_THROW(recorder.record(source.reset, 0), std::invalid_argument);
+    EmptySerializer<EventArgs> serializer;
+    ASSERT_THROW(recorder.append(0, EventArgs(), serializer), std::invalid_argument);
+    ASSERT_EQ(0, recorder.used());
+}
+
+TEST(EventRecorderTests, TestInvalidLog)
+{
+    std::vector<std::uint64_t> memory(16);
+    ASSERT_THROW(EventReplayer<>(std::as_bytes(std::span(memory))), std::invalid_argument);
+    ASSERT_THROW(EventRecorder<>(std::as_writable_bytes(std::span(memory)).first(8)),
+        std::invalid_argument);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(EventRecorderTests, TestMappedFile)
+{
+    auto path = testing::TempDir() + "EventRecorderTests.log";
+    Recorded source;
+    {
+        MappedFile file(path, 4096);
+        EventRecorder<> recorder(file.data());
+        recorder.record(source.valueChanged, 7, ValueSerializer());
+        ValueEventArgs e(42);
+        source.valueChanged(source, e);
+    }
+    int replayed = 0;
+    source.valueChanged += [&replayed](Recorded&, ValueEventArgs& e) { replayed = e.value(); };
+    {
+        MappedFile file(path);
+        EventReplayer<> replayer(file.data());
+        replayer.add(7, source.valueChanged, source, ValueSerializer());
+        ASSERT_EQ(1, replayer.replay());
+    }
+    ASSERT_EQ(42, replayed);
+    std::remove(path.c_str());
+}
+#endif
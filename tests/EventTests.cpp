@@ -5,9 +5,20 @@
 #include <gtest/gtest.h>
 #include "Event.h"
 #include "EventHandler.h"
+#include "BatchingExecutor.h"
+#include "DispatchQueue.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <concepts>
 #include <type_traits>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 
 using namespace jimo;
 
@@ -42,3 +53,324 @@ TEST(EventTests, TestEquality)
     object2.anEvent += func;
     ASSERT_TRUE(object.anEvent == object2.anEvent);
 }
+
+TEST(EventTests, TestInvokeParallelHalt)
+{
+    interthread::ThreadPool pool(1);
+    MyObj object;
+    std::atomic<int> calls = 0;
+    object.anEvent += [&calls](MyObj&, EventArgs& e) { ++calls; e.halt(true); };
+    object.anEvent += [&calls](MyObj&, EventArgs&) { ++calls; };
+    object.anEvent += [&calls](MyObj&, EventArgs&) { ++calls; };
+    EventArgs args;
+    object.anEvent.invokeParallel(pool, object, args);
+    // The first handler always starts first. At most one other handler can have been
+    // started before it set halt, because only the pool thread and this thread run handlers.
+    ASSERT_GE(calls, 1);
+    ASSERT_LE(calls, 2);
+    ASSERT_TRUE(args.halt());
+}
+
+TEST(EventTests, TestInvokeBatchHalt)
+{
+    MyObj object;
+    int calls = 0;
+    object.anEvent += [&calls](MyObj&, EventArgs& e) { ++calls; e.halt(true); };
+    object.anEvent += [&calls](MyObj&, EventArgs&) { ++calls; };
+    for (auto order : { BatchOrder::EventMajor, BatchOrder::HandlerMajor })
+    {
+        calls = 0;
+        EventArgs args1;
+        EventArgs args2;
+        std::vector<std::tuple<MyObj&, EventArgs&>> batch;
+        batch.emplace_back(object, args1);
+        batch.emplace_back(object, args2);
+        object.anEvent.invokeBatch(batch, order);
+        ASSERT_EQ(2, calls);
+        ASSERT_TRUE(args1.halt());
+        ASSERT_TRUE(args2.halt());
+    }
+}
+
+TEST(EventTests, TestTrackedSubscription)
+{
+    MyObj object;
+    auto calls = std::make_shared<int>(0);
+    object.anEvent.subscribe([calls = calls.get()](MyObj&, EventArgs&) { ++*calls; }, calls);
+    EventArgs args;
+    object.anEvent(object, args);
+    ASSERT_EQ(1, *calls);
+    calls.reset();
+    object.anEvent(object, args);
+    ASSERT_TRUE(object.anEvent.empty());
+}
+
+TEST(EventTests, TestPriorityHalt)
+{
+    MyObj object;
+    int calls = 0;
+    object.anEvent += [&calls](MyObj&, EventArgs&) { ++calls; };
+    object.anEvent += { [](MyObj&, EventArgs& e) { e.halt(true); }, 1 };
+    EventArgs args;
+    object.anEvent(object, args);
+    ASSERT_EQ(0, calls);
+    ASSERT_TRUE(args.halt());
+}
+
+// A coroutine that starts immediately and destroys itself when it finishes.
+struct FireAndForget
+{
+    struct promise_type
+    {
+        FireAndForget get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+FireAndForget countOccurrences(Event<MyObj, EventArgs>& event, MyObj*& sender, int& count, int times)
+{
+    for (int time = 0; time < times; ++time)
+    {
+        auto [from, e] = co_await event;
+        sender = &from;
+        ++count;
+    }
+}
+
+TEST(EventTests, TestAwait)
+{
+    MyObj object;
+    MyObj* sender = nullptr;
+    int count = 0;
+    countOccurrences(object.anEvent, sender, count, 2);
+    ASSERT_EQ(0, count);
+    EventArgs args;
+    object.anEvent(object, args);
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(&object, sender);
+    object.anEvent(object, args);
+    object.anEvent(object, args);
+    ASSERT_EQ(2, count);
+}
+
+TEST(EventTests, TestAwaitManyWaiters)
+{
+    MyObj object;
+    MyObj* sender = nullptr;
+    int count = 0;
+    for (int waiter = 0; waiter < 1000; ++waiter)
+    {
+        countOccurrences(object.anEvent, sender, count, 1);
+    }
+    EventArgs args;
+    object.anEvent(object, args);
+    ASSERT_EQ(1000, count);
+    object.anEvent(object, args);
+    ASSERT_EQ(1000, count);
+}
+
+// A coroutine that starts immediately and is destroyed with its Owned object.
+struct Owned
+{
+    struct promise_type
+    {
+        Owned get_return_object() noexcept
+        {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+    Owned(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Owned(const Owned&) = delete;
+    ~Owned() { handle.destroy(); }
+    std::coroutine_handle<promise_type> handle;
+};
+
+Owned awaitOnce(Event<MyObj, EventArgs>& event, int& count, bool& cancelled)
+{
+    try
+    {
+        co_await event;
+        ++count;
+    }
+    catch (const std::runtime_error&)
+    {
+        cancelled = true;
+    }
+}
+
+TEST(EventTests, TestAwaitDestroyedCoroutine)
+{
+    MyObj object;
+    int count = 0;
+    bool cancelled = false;
+    // Destroy waiters at the head, in the middle, and at the tail of the list.
+    auto head = std::unique_ptr<Owned>(new Owned(awaitOnce(object.anEvent, count, cancelled)));
+    auto first = awaitOnce(object.anEvent, count, cancelled);
+    {
+        auto middle = awaitOnce(object.anEvent, count, cancelled);
+    }
+    auto last = awaitOnce(object.anEvent, count, cancelled);
+    {
+        auto tail = awaitOnce(object.anEvent, count, cancelled);
+    }
+    head.reset();
+    EventArgs args;
+    object.anEvent(object, args);
+    ASSERT_EQ(2, count);
+    ASSERT_TRUE(first.handle.done());
+    ASSERT_TRUE(last.handle.done());
+    object.anEvent(object, args);
+    ASSERT_EQ(2, count);
+    ASSERT_FALSE(cancelled);
+}
+
+TEST(EventTests, TestAwaitDestroyedEvent)
+{
+    int count = 0;
+    bool cancelled = false;
+    auto event = std::make_unique<Event<MyObj, EventArgs>>();
+    auto waiting = awaitOnce(*event, count, cancelled);
+    ASSERT_FALSE(waiting.handle.done());
+    event.reset();
+    ASSERT_TRUE(waiting.handle.done());
+    ASSERT_TRUE(cancelled);
+    ASSERT_EQ(0, count);
+}
+
+TEST(EventTests, TestAwaitInvokeBatch)
+{
+    MyObj object;
+    MyObj* sender = nullptr;
+    int count = 0;
+    countOccurrences(object.anEvent, sender, count, 2);
+    EventArgs args1;
+    EventArgs args2;
+    std::vector<std::tuple<MyObj&, EventArgs&>> batch;
+    batch.emplace_back(object, args1);
+    batch.emplace_back(object, args2);
+    object.anEvent.invokeBatch(batch);
+    ASSERT_EQ(2, count);
+}
+
+FireAndForget awaitOnExecutor(Event<MyObj, EventArgs>& event, interthread::Executor& executor,
+    std::thread::id& resumedOn, std::latch& done)
+{
+    co_await event.next(executor);
+    resumedOn = std::this_thread::get_id();
+    done.count_down();
+}
+
+TEST(EventTests, TestAwaitOnExecutor)
+{
+    MyObj object;
+    interthread::ThreadPool pool(1);
+    std::thread::id resumedOn;
+    std::latch done(1);
+    awaitOnExecutor(object.anEvent, pool, resumedOn, done);
+    EventArgs args;
+    object.anEvent(object, args);
+    done.wait();
+    ASSERT_NE(std::this_thread::get_id(), resumedOn);
+}
+
+TEST(EventTests, TestPost)
+{
+    MyObj object;
+    std::vector<bool> halts;
+    std::thread::id handledOn;
+    object.anEvent += [&halts, &handledOn](MyObj&, EventArgs& e) {
+        halts.push_back(e.halt());
+        handledOn = std::this_thread::get_id();
+    };
+    {
+        interthread::DispatchQueue queue;
+        EventArgs args;
+        object.anEvent.post(queue, object, args);
+        args.halt(true);
+        object.anEvent.post(queue, object, args);
+    }
+    ASSERT_EQ((std::vector<bool>{ false, true }), halts);
+    ASSERT_NE(std::this_thread::get_id(), handledOn);
+}
+
+TEST(EventTests, TestAffineSubscription)
+{
+    MyObj object;
+    std::vector<int> order;
+    std::thread::id inlineOn;
+    std::thread::id affineOn;
+    int affineHalts = 0;
+    {
+        interthread::DispatchQueue queue;
+        object.anEvent += [&order, &inlineOn](MyObj&, EventArgs&) {
+            order.push_back(1);
+            inlineOn = std::this_thread::get_id();
+        };
+        object.anEvent += { [&affineOn, &affineHalts](MyObj&, EventArgs& e) {
+            affineOn = std::this_thread::get_id();
+            affineHalts += e.halt() ? 1 : 0;
+            e.halt(true);
+        }, queue };
+        object.anEvent += [&order](MyObj&, EventArgs& e) {
+            order.push_back(e.halt() ? -2 : 2);
+        };
+        ASSERT_EQ(3, object.anEvent.size());
+        EventArgs args;
+        object.anEvent(object, args);
+        ASSERT_FALSE(args.halt());
+    }
+    ASSERT_EQ((std::vector<int>{ 1, 2 }), order);
+    ASSERT_EQ(std::this_thread::get_id(), inlineOn);
+    ASSERT_NE(std::this_thread::get_id(), affineOn);
+    ASSERT_EQ(0, affineHalts);
+}
+
+class LargestPostedArgs : public EventArgs
+{
+    public:
+        char payload[Event<MyObj, EventArgs>::maxPostedArgsSize - sizeof(EventArgs)] {};
+};
+
+TEST(EventTests, TestPostLargestArgs)
+{
+    static_assert(sizeof(LargestPostedArgs) == Event<MyObj, EventArgs>::maxPostedArgsSize);
+    MyObj object;
+    Event<MyObj, LargestPostedArgs> largeEvent;
+    std::vector<char> received;
+    {
+        interthread::DispatchQueue queue;
+        largeEvent += { [&received](MyObj&, LargestPostedArgs& e) {
+            received.push_back(e.payload[sizeof(e.payload) - 1]);
+        }, queue };
+        LargestPostedArgs args;
+        args.payload[sizeof(args.payload) - 1] = 'a';
+        largeEvent(object, args);
+        args.payload[sizeof(args.payload) - 1] = 'b';
+        largeEvent.post(queue, object, args);
+    }
+    ASSERT_EQ((std::vector<char>{ 'a', 'b' }), received);
+}
+
+TEST(EventTests, TestAffineConnection)
+{
+    MyObj object;
+    std::atomic<int> calls = 0;
+    interthread::ThreadPool pool(2);
+    interthread::BatchingExecutor batch(pool);
+    auto connection = object.anEvent.subscribe({ [&calls](MyObj&, EventArgs&) { ++calls; }, batch });
+    std::latch done(1);
+    object.anEvent.subscribe({ [&done](MyObj&, EventArgs&) { done.count_down(); }, batch });
+    EventArgs args;
+    object.anEvent(object, args);
+    done.wait();
+    ASSERT_EQ(1, calls);
+    connection.disconnect();
+    ASSERT_EQ(1, object.anEvent.size());
+}
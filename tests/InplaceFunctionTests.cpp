@@ -0,0 +1,112 @@
+/// @file InplaceFunctionTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <array>
+#include <functional>
+#include <memory>
+#include "InplaceFunction.h"
+
+using namespace jimo;
+
+int addOne(int x) { return x + 1; }
+
+TEST(InplaceFunctionTests, TestEmpty)
+{
+    InplaceFunction<int(int)> function;
+    InplaceFunction<int(int)> function2(nullptr);
+    int (*nullFunction)(int) = nullptr;
+    InplaceFunction<int(int)> function3(nullFunction);
+    ASSERT_FALSE(function);
+    ASSERT_FALSE(function2);
+    ASSERT_FALSE(function3);
+    ASSERT_THROW(function(1), std::bad_function_call);
+}
+
+TEST(InplaceFunctionTests, TestFunctionAndLambda)
+{
+    InplaceFunction<int(int)> function(addOne);
+    ASSERT_TRUE(function);
+    ASSERT_EQ(3, function(2));
+    int offset = 10;
+    function = [offset](int x) { return x + offset; };
+    ASSERT_EQ(12, function(2));
+    function = nullptr;
+    ASSERT_FALSE(function);
+}
+
+TEST(InplaceFunctionTests, TestCopyAndMove)
+{
+    std::array<int, 8> values { 1, 2, 3, 4, 5, 6, 7, 8 };
+    InplaceFunction<int(int), 64> function([values](int index) { return values[index]; });
+    auto copy = function;
+    ASSERT_EQ(4, copy(3));
+    ASSERT_EQ(4, function(3));
+    auto moved = std::move(function);
+    ASSERT_FALSE(function);
+    ASSERT_EQ(8, moved(7));
+}
+
+TEST(InplaceFunctionTests, TestMoveOnly)
+{
+    auto value = std::make_unique<int>(42);
+    InplaceFunction<int(), inplaceFunctionCapacity, false> function(
+        [value = std::move(value)]() { return *value; });
+    static_assert(!std::is_copy_constructible_v<decltype(function)>);
+    auto moved = std::move(function);
+    ASSERT_FALSE(function);
+    ASSERT_EQ(42, moved());
+}
+
+TEST(InplaceFunctionTests, TestTarget)
+{
+    InplaceFunction<int(int)> function(addOne);
+    ASSERT_TRUE(function.target_type() == typeid(int(*)(int)));
+    ASSERT_EQ(&addOne, *function.target<int(*)(int)>());
+    ASSERT_EQ(nullptr, function.target<std::function<int(int)>>());
+    InplaceFunction<int(int)> empty;
+    ASSERT_TRUE(empty.target_type() == typeid(void));
+}
+
+TEST(InplaceFunctionTests, TestVoidResultDiscardsValue)
+{
+    int calls = 0;
+    InplaceFunction<void(int)> function([&calls](int x) { ++calls; return x; });
+    function(1);
+    ASSERT_EQ(1, calls);
+}
+
+TEST(InplaceFunctionTests, TestSameTarget)
+{
+    auto lambda = [](int x) { return x; };
+    InplaceFunction<int(int)> function(addOne);
+    InplaceFunction<int(int)> function2(addOne);
+    InplaceFunction<int(int)> function3([](int x) { return x + 1; });
+    InplaceFunction<int(int)> function4(lambda);
+    InplaceFunction<int(int)> function5(lambda);
+    InplaceFunction<int(int)> empty;
+    ASSERT_TRUE(function.sameTarget(function2));
+    ASSERT_FALSE(function.sameTarget(function3));
+    ASSERT_TRUE(function4.sameTarget(function5));
+    ASSERT_FALSE(function.sameTarget(empty));
+    ASSERT_TRUE(empty.sameTarget(InplaceFunction<int(int)>()));
+}
+
+int addTwo(int x) { return x + 2; }
+
+TEST(InplaceFunctionTests, TestTargetHash)
+{
+    auto lambda = [](int x) { return x; };
+    InplaceFunction<int(int)> function(addOne);
+    InplaceFunction<int(int)> function2(addOne);
+    InplaceFunction<int(int)> function3(addTwo);
+    InplaceFunction<int(int)> function4(lambda);
+    InplaceFunction<int(int)> function5(lambda);
+    ASSERT_EQ(function.targetHash(), function2.targetHash());
+    ASSERT_NE(function.targetHash(), function3.targetHash());
+    ASSERT_NE(0, function.targetHash());
+    ASSERT_EQ(0, function4.targetHash());
+    ASSERT_EQ(0, function5.targetHash());
+    ASSERT_EQ(0, InplaceFunction<int(int)>().targetHash());
+}
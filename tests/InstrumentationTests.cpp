@@ -0,0 +1,87 @@
+/// @file InstrumentationTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+// These tests are built into their own executable, because every translation unit in a
+// program must agree on whether JIMO_DELEGATE_INSTRUMENTATION is defined.
+#define JIMO_DELEGATE_INSTRUMENTATION
+#include <gtest/gtest.h>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "Delegate.h"
+#include "Event.h"
+#include "EventArgs.h"
+#include "Object.h"
+
+using namespace jimo;
+using namespace jimo::timing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    int addOne(int x) { return x + 1; }
+    int sleepThenAddTwo(int x)
+    {
+        std::this_thread::sleep_for(1ms);
+        return x + 2;
+    }
+}
+
+TEST(InstrumentationTests, TestCounts)
+{
+    Delegate<int, int> delegate { addOne, sleepThenAddTwo };
+    ASSERT_EQ(5, delegate(3));
+    ASSERT_EQ(6, delegate(4));
+    auto statistics = delegate.statistics();
+    ASSERT_EQ(2, statistics.size());
+    ASSERT_EQ(typeid(int(*)(int)), *statistics[0].type);
+    ASSERT_EQ(2, statistics[0].invocations);
+    ASSERT_EQ(2, statistics[1].invocations);
+    ASSERT_GE(statistics[1].totalTime, 2ms);
+    ASSERT_LT(statistics[0].totalTime, statistics[1].totalTime);
+    for (const auto& handler : statistics)
+    {
+        ASSERT_EQ(handler.invocations,
+            std::accumulate(handler.histogram.begin(), handler.histogram.end(), std::uint64_t { 0 }));
+    }
+    // A 1 ms call falls in the bucket for 2^19 to 2^20 - 1 nanoseconds, or a later one.
+    ASSERT_EQ(0, std::accumulate(statistics[1].histogram.begin(),
+        statistics[1].histogram.begin() + 19, std::uint64_t { 0 }));
+}
+
+TEST(InstrumentationTests, TestStatisticsSurviveChanges)
+{
+    Delegate<int, int> delegate { addOne };
+    delegate(1);
+    delegate += sleepThenAddTwo;
+    delegate(1);
+    auto statistics = delegate.statistics();
+    ASSERT_EQ(2, statistics[0].invocations);
+    ASSERT_EQ(1, statistics[1].invocations);
+    delegate.resetStatistics();
+    statistics = delegate.statistics();
+    ASSERT_EQ(0, statistics[0].invocations);
+    ASSERT_EQ(0, statistics[0].totalTime.count());
+}
+
+TEST(InstrumentationTests, TestExceptionIsRecorded)
+{
+    Delegate<void> delegate { []() { throw std::runtime_error("handler failed"); } };
+    ASSERT_THROW(delegate(), std::runtime_error);
+    ASSERT_EQ(1, delegate.statistics()[0].invocations);
+}
+
+TEST(InstrumentationTests, TestEvent)
+{
+    Event<Object, EventArgs> event;
+    event += [](Object&, EventArgs& e) { e.halt(true); };
+    event += [](Object&, EventArgs&) {};
+    Object sender;
+    EventArgs args;
+    event(sender, args);
+    auto statistics = event.statistics();
+    ASSERT_EQ(1, statistics[0].invocations);
+    ASSERT_EQ(0, statistics[1].invocations);
+}
@@ -0,0 +1,147 @@
+/// @file RateLimiterTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "RateLimiter.h"
+
+using namespace jimo;
+using namespace jimo::timing;
+using namespace std::chrono_literals;
+
+// A clock that only moves when a test advances it.
+struct ManualClock
+{
+    using rep = long long;
+    using period = std::nano;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+    static time_point now() noexcept { return current; }
+    static inline time_point current {};
+};
+
+class NumberEventArgs : public EventArgs
+{
+    public:
+        NumberEventArgs(int number) : m_number(number) {}
+        int number() const noexcept { return m_number; }
+    private:
+        int m_number;
+};
+
+class Source : public Object
+{
+    public:
+        Event<Source, NumberEventArgs> changed;
+        void fire(int number)
+        {
+            NumberEventArgs e(number);
+            changed(*this, e);
+        }
+};
+
+// Records the numbers that are forwarded, and lets a test wait for them.
+class Recorder
+{
+    public:
+        void operator ()(Source&, NumberEventArgs& e)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_numbers.push_back(e.number());
+            m_changed.notify_all();
+        }
+        std::vector<int> waitFor(std::size_t count)
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_changed.wait_for(lock, 5s, [this, count]() { return m_numbers.size() >= count; });
+            return m_numbers;
+        }
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_changed;
+        std::vector<int> m_numbers;
+};
+
+TEST(RateLimiterTests, TestThrottleLeading)
+{
+    Source source;
+    Throttle<Source, NumberEventArgs, ManualClock> throttle(source.changed, 10ms);
+    ASSERT_EQ(Edge::Leading, throttle.edge());
+    ASSERT_EQ(10ms, throttle.window());
+    std::vector<int> numbers;
+    throttle.forwarded += [&numbers](Source&, NumberEventArgs& e) { numbers.push_back(e.number()); };
+    source.fire(1);
+    ManualClock::current += 4ms;
+    source.fire(2);
+    ManualClock::current += 4ms;
+    source.fire(3);
+    ManualClock::current += 4ms;
+    source.fire(4);
+    source.fire(5);
+    ManualClock::current += 10ms;
+    source.fire(6);
+    ASSERT_EQ((std::vector<int>{ 1, 4, 6 }), numbers);
+}
+
+TEST(RateLimiterTests, TestDebounceLeading)
+{
+    Source source;
+    Debounce<Source, NumberEventArgs, ManualClock> debounce(source.changed, 10ms, Edge::Leading);
+    std::vector<int> numbers;
+    debounce.forwarded += [&numbers](Source&, NumberEventArgs& e) { numbers.push_back(e.number()); };
+    source.fire(1);
+    for (int number = 2; number < 6; ++number)
+    {
+        ManualClock::current += 6ms;
+        source.fire(number);
+    }
+    ManualClock::current += 10ms;
+    source.fire(6);
+    ASSERT_EQ((std::vector<int>{ 1, 6 }), numbers);
+}
+
+TEST(RateLimiterTests, TestDebounceTrailing)
+{
+    Source source;
+    Recorder recorder;
+    {
+        Debounce<Source, NumberEventArgs> debounce(source.changed, 200ms);
+        debounce.forwarded += [&recorder](Source& sender, NumberEventArgs& e) { recorder(sender, e); };
+        for (int number = 1; number <= 100; ++number)
+        {
+            source.fire(number);
+        }
+        ASSERT_EQ((std::vector<int>{ 100 }), recorder.waitFor(1));
+    }
+}
+
+TEST(RateLimiterTests, TestThrottleBoth)
+{
+    Source source;
+    Recorder recorder;
+    {
+        Throttle<Source, NumberEventArgs> throttle(source.changed, 200ms, Edge::Both);
+        throttle.forwarded += [&recorder](Source& sender, NumberEventArgs& e) { recorder(sender, e); };
+        for (int number = 1; number <= 100; ++number)
+        {
+            source.fire(number);
+        }
+        ASSERT_EQ((std::vector<int>{ 1, 100 }), recorder.waitFor(2));
+    }
+}
+
+TEST(RateLimiterTests, TestUnsubscribesOnDestruction)
+{
+    Source source;
+    {
+        Throttle<Source, NumberEventArgs> throttle(source.changed, 10ms, Edge::Trailing);
+        ASSERT_EQ(1, source.changed.size());
+    }
+    source.fire(1);
+    ASSERT_TRUE(source.changed.empty());
+}
@@ -0,0 +1,199 @@
+/// @file SharedEventChannelTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "SharedEventChannel.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace jimo;
+using namespace jimo::interprocess;
+
+class ValueEventArgs : public EventArgs
+{
+    public:
+        ValueEventArgs(int value = 0) : m_value(value) {}
+        int value() const noexcept { return m_value; }
+    private:
+        int m_value;
+};
+
+struct ValueSerializer
+{
+    std::size_t size(const ValueEventArgs&) const noexcept { return sizeof(int); }
+    void write(const ValueEventArgs& e, std::span<std::byte> out) const noexcept
+    {
+        auto value = e.value();
+        std::memcpy(out.data(), &value, sizeof(value));
+    }
+    ValueEventArgs read(std::span<const std::byte> in) const
+    {
+        int value;
+        std::memcpy(&value, in.data(), sizeof(value));
+        return ValueEventArgs(value);
+    }
+};
+
+using ValueChannel = SharedEventChannel<ValueEventArgs, ValueSerializer>;
+
+class Publisher : public Object
+{
+    public:
+        Event<Publisher, ValueEventArgs> valueChanged;
+};
+
+static std::string channelName()
+{
+    return "/jimoSharedEventChannelTests" + std::to_string(::getpid());
+}
+
+static std::vector<int> collect(ValueChannel& channel)
+{
+    std::vector<int> values;
+    channel.received += [&values](ValueChannel&, ValueEventArgs& e) { values.push_back(e.value()); };
+    channel.poll();
+    channel.received.clear();
+    return values;
+}
+
+TEST(SharedEventChannelTests, TestConstructor)
+{
+    ValueChannel channel(channelName(), 100, 12);
+    ASSERT_EQ(128, channel.capacity());
+    ASSERT_EQ(48, channel.maxArgsSize());
+    ValueChannel opened(channelName());
+    ASSERT_EQ(128, opened.capacity());
+    ASSERT_EQ(48, opened.maxArgsSize());
+    ASSERT_THROW(ValueChannel(channelName(), 0, 12), std::invalid_argument);
+}
+
+TEST(SharedEventChannelTests, TestOpenMissing)
+{
+    ASSERT_THROW(ValueChannel("/jimoSharedEventChannelTestsMissing"), std::system_error);
+    SharedMemory memory(channelName(), 4096);
+    ASSERT_THROW(ValueChannel channel(channelName()), std::invalid_argument);
+}
+
+TEST(SharedEventChannelTests, TestPublishAndPoll)
+{
+    ValueChannel publisher(channelName(), 16, sizeof(int));
+    ValueEventArgs before(1);
+    publisher.publish(before);
+    ValueChannel receiver(channelName());
+    ASSERT_FALSE(receiver.wait(std::chrono::milliseconds(1)));
+    for (int value : { 2, 3, 4 })
+    {
+        ValueEventArgs e(value);
+        publisher.publish(e);
+    }
+    ASSERT_TRUE(receiver.wait(std::chrono::milliseconds(1)));
+    ASSERT_EQ((std::vector<int>{ 2, 3, 4 }), collect(receiver));
+    ASSERT_EQ((std::vector<int>{ 1, 2, 3, 4 }), collect(publisher));
+    ASSERT_EQ(0, receiver.poll());
+    ASSERT_EQ(0, receiver.dropped());
+}
+
+TEST(SharedEventChannelTests, TestArgsTooLarge)
+{
+    struct WideSerializer : ValueSerializer
+    {
+        std::size_t size(const ValueEventArgs&) const noexcept { return 100; }
+    };
+    SharedEventChannel<ValueEventArgs, WideSerializer> channel(channelName(), 4, 16);
+    ASSERT_THROW(channel.publish(ValueEventArgs(1)), std::length_error);
+}
+
+TEST(SharedEventChannelTests, TestOverrun)
+{
+    ValueChannel publisher(channelName(), 4, sizeof(int));
+    ValueChannel receiver(channelName());
+    for (int value = 0; value < 10; ++value)
+    {
+        publisher.publish(ValueEventArgs(value));
+    }
+    ASSERT_EQ((std::vector<int>{ 6, 7, 8, 9 }), collect(receiver));
+    ASSERT_EQ(6, receiver.dropped());
+}
+
+TEST(SharedEventChannelTests, TestForward)
+{
+    Publisher source;
+    ValueChannel publisher(channelName(), 16, sizeof(int));
+    ValueChannel receiver(channelName());
+    auto connection = publisher.forward(source.valueChanged);
+    source.valueChanged += [](Publisher&, ValueEventArgs& e) { e.halt(true); };
+    source.valueChanged += [](Publisher&, ValueEventArgs&) { FAIL(); };
+    ValueEventArgs e(5);
+    source.valueChanged(source, e);
+    connection.disconnect();
+    source.valueChanged(source, e);
+    ASSERT_EQ((std::vector<int>{ 5 }), collect(receiver));
+}
+
+TEST(SharedEventChannelTests, TestRun)
+{
+    ValueChannel publisher(channelName(), 16, sizeof(int));
+    ValueChannel receiver(channelName());
+    std::atomic<int> value = 0;
+    receiver.received += [&value](ValueChannel&, ValueEventArgs& e) { value = e.value(); };
+    {
+        std::jthread thread([&receiver](std::stop_token stopToken) { receiver.run(stopToken); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        publisher.publish(ValueEventArgs(7));
+        while (value == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    ASSERT_EQ(7, value);
+}
+
+TEST(SharedEventChannelTests, TestOtherProcess)
+{
+    auto name = channelName();
+    ValueChannel receiver(name, 64, sizeof(int));
+    auto child = ::fork();
+    ASSERT_NE(-1, child);
+    if (child == 0)
+    {
+        try
+        {
+            ValueChannel publisher(name);
+            for (int value = 0; value < 50; ++value)
+            {
+                publisher.publish(ValueEventArgs(value));
+            }
+        }
+        catch (...)
+        {
+            ::_exit(1);
+        }
+        ::_exit(0);
+    }
+    std::vector<int> values;
+    receiver.received += [&values](ValueChannel&, ValueEventArgs& e) { values.push_back(e.value()); };
+    while (values.size() < 50 && receiver.wait(std::chrono::seconds(5)))
+    {
+        receiver.poll();
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_EQ(0, status);
+    ASSERT_EQ(50, values.size());
+    for (int value = 0; value < 50; ++value)
+    {
+        ASSERT_EQ(value, values[value]);
+    }
+}
+#endif
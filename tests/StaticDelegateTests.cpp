@@ -0,0 +1,100 @@
+/// @file StaticDelegateTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include "StaticDelegate.h"
+
+using namespace jimo;
+
+namespace
+{
+    int addOne(int x) { return x + 1; }
+    int addTwo(int x) { return x + 2; }
+
+    class Adder
+    {
+        public:
+            Adder(int value) : m_value(value) {}
+            int add(int x) const { return x + m_value; }
+        private:
+            int m_value;
+    };
+}
+
+TEST(StaticDelegateTests, TestEmpty)
+{
+    StaticDelegate<4, int, int> delegate;
+    ASSERT_TRUE(delegate.empty());
+    ASSERT_EQ(0, delegate.size());
+    ASSERT_EQ(4, delegate.max_size());
+    ASSERT_EQ(0, delegate(1));
+}
+
+TEST(StaticDelegateTests, TestPlusEqualsAndInvoke)
+{
+    Adder adder(10);
+    StaticDelegate<3, int, int> delegate { addOne };
+    delegate += addTwo;
+    delegate += { adder, &Adder::add };
+    ASSERT_EQ(3, delegate.size());
+    ASSERT_TRUE(delegate.full());
+    ASSERT_EQ(15, delegate(5));
+    ASSERT_EQ(16, delegate.invokeWith(combiners::Sum<int>(), 1));
+    ASSERT_THROW(delegate += addOne, std::length_error);
+    ASSERT_EQ(3, delegate.size());
+}
+
+TEST(StaticDelegateTests, TestMinusEquals)
+{
+    Adder adder(10);
+    Adder adder2(20);
+    StaticDelegate<8, int, int> delegate { addOne, addTwo, addOne };
+    delegate += { adder, &Adder::add };
+    delegate += { adder2, &Adder::add };
+    delegate -= addOne;
+    ASSERT_EQ(3, delegate.size());
+    delegate -= { adder, &Adder::add };
+    ASSERT_EQ(2, delegate.size());
+    ASSERT_EQ(21, delegate(1));
+    StaticDelegate<2, int, int> removed { addTwo };
+    delegate -= removed;
+    ASSERT_EQ(1, delegate.size());
+    delegate -= delegate;
+    ASSERT_TRUE(delegate.empty());
+}
+
+TEST(StaticDelegateTests, TestCombineAndEqual)
+{
+    StaticDelegate<2, int, int> delegate { addOne, addTwo };
+    StaticDelegate<4, int, int> delegate2 { addOne };
+    ASSERT_FALSE(delegate2 == delegate);
+    delegate2 += addTwo;
+    ASSERT_TRUE(delegate2 == delegate);
+    delegate2 += delegate;
+    ASSERT_EQ(4, delegate2.size());
+    ASSERT_THROW(delegate2 += delegate, std::length_error);
+    delegate2.clear();
+    ASSERT_TRUE(delegate2.empty());
+}
+
+TEST(StaticDelegateTests, TestCopy)
+{
+    StaticDelegate<2, int, int> delegate { addOne };
+    auto copy = delegate;
+    copy += addTwo;
+    ASSERT_EQ(1, delegate.size());
+    ASSERT_EQ(2, copy.size());
+}
+
+TEST(StaticDelegateTests, TestMoveOnlyArgument)
+{
+    int seen = 0;
+    StaticDelegate<2, int, std::unique_ptr<int>> delegate {
+        [&seen](const std::unique_ptr<int>& value) { seen = *value; return 0; },
+        [](std::unique_ptr<int> value) { return *value * 2; } };
+    ASSERT_EQ(42, delegate(std::make_unique<int>(21)));
+    ASSERT_EQ(21, seen);
+}
@@ -0,0 +1,32 @@
+/// @file StaticEventTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include "StaticEvent.h"
+
+using namespace jimo;
+
+namespace
+{
+    class Publisher : public Object
+    {
+        public:
+            StaticEvent<4, Publisher, EventArgs> published;
+    };
+}
+
+TEST(StaticEventTests, TestInvokeAndHalt)
+{
+    Publisher publisher;
+    int calls = 0;
+    publisher.published += [&calls](Publisher&, EventArgs&) { ++calls; };
+    publisher.published += [&calls](Publisher&, EventArgs& e) { ++calls; e.halt(true); };
+    publisher.published += [&calls](Publisher&, EventArgs&) { ++calls; };
+    EventArgs e;
+    publisher.published(publisher, e);
+    ASSERT_EQ(2, calls);
+    EventArgs e2;
+    publisher.published.invoke(publisher, e2);
+    ASSERT_EQ(4, calls);
+}
@@ -0,0 +1,55 @@
+/// @file ThreadPoolTests.cpp
+/// @author Jim Orcheson
+/// @copyright 2022 Jim Orcheson. Use dictated by MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <latch>
+#include <stdexcept>
+#include <vector>
+#include "ThreadPool.h"
+
+using namespace jimo::interthread;
+
+TEST(ThreadPoolTests, TestPost)
+{
+    ThreadPool pool(2);
+    ASSERT_EQ(2, pool.size());
+    std::atomic<int> count = 0;
+    std::latch done(10);
+    for (int task = 0; task < 10; ++task)
+    {
+        pool.post([&count, &done]() {
+            ++count;
+            done.count_down();
+        });
+    }
+    done.wait();
+    ASSERT_EQ(10, count);
+}
+
+TEST(ThreadPoolTests, TestParallelFor)
+{
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> calls(100);
+    pool.parallelFor(calls.size(), [&calls](std::size_t index) { ++calls[index]; });
+    for (const auto& call : calls)
+    {
+        ASSERT_EQ(1, call);
+    }
+    pool.parallelFor(0, [](std::size_t) { FAIL(); });
+}
+
+TEST(ThreadPoolTests, TestParallelForRethrows)
+{
+    ThreadPool pool(2);
+    std::atomic<int> calls = 0;
+    ASSERT_THROW(pool.parallelFor(8, [&calls](std::size_t index) {
+        ++calls;
+        if (index == 3)
+        {
+            throw std::runtime_error("index 3");
+        }
+    }), std::runtime_error);
+    ASSERT_EQ(8, calls);
+}